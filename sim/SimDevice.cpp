@@ -0,0 +1,52 @@
+#include "SimDevice.h"
+#include "definitions.h"
+#include "SimBoard.h"
+#include "SimHeap.h"
+#include <WebServer.h>
+
+SimDevice::SimDevice() : _boots(0), _lastLeak(0), _lastBootHeap() {}
+
+SimDevice::~SimDevice() {
+    shutdown();
+}
+
+void SimDevice::boot() {
+    sim::heapReset();
+    sim::resetPins();
+    sim::setNow(0);
+    _boots++;
+    
+    // Global construction order of src/main.cpp
+    _blinker.reset(new SOSBlinker(PIN_LED_SOS));
+    _config.reset(new ConfigManager());
+    _net.reset(new NetworkManager(*_config, *_blinker));
+    
+    // setup()
+    Serial.begin(115200);
+    delay(100);
+    _config->begin();
+    _net->begin();
+    _blinker->begin();
+}
+
+bool SimDevice::loop() {
+    try {
+        _net->update();
+        _blinker->update();
+    } catch (const sim::Restart&) {
+        _lastLeak = shutdown();
+        _lastBootHeap = sim::heapStats();
+        boot();
+        return false;
+    }
+    return true;
+}
+
+size_t SimDevice::shutdown() {
+    _net.reset();
+    _config.reset();
+    _blinker.reset();
+    sim::httpReset();
+    sim::wifiReset();
+    return sim::heapStats().used;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <memory>
+#include "ConfigManager.h"
+#include "NetworkManager.h"
+#include "SOSBlinker.h"
+#include "SimHeap.h"
+
+// The firmware's setup()/loop() from src/main.cpp, around objects that can be
+// torn down and rebuilt so ESP.restart() becomes a real reboot: fresh heap,
+// millis() back to 0, NVS kept.
+class SimDevice {
+public:
+    SimDevice();
+    ~SimDevice();
+
+    void boot();
+    // One pass of loop(); returns false if the firmware restarted the device
+    bool loop();
+    // Destroys the firmware objects; returns heap bytes still allocated (leaks)
+    size_t shutdown();
+
+    NetworkManager& net() { return *_net; }
+    SOSBlinker& blinker() { return *_blinker; }
+    uint32_t boots() const { return _boots; }
+    // Heap bytes left allocated when the last reboot tore the firmware down
+    size_t lastLeak() const { return _lastLeak; }
+    // Heap counters of the boot that ended with the last reboot
+    const sim::HeapStats& lastBootHeap() const { return _lastBootHeap; }
+
+private:
+    std::unique_ptr<SOSBlinker> _blinker;
+    std::unique_ptr<ConfigManager> _config;
+    std::unique_ptr<NetworkManager> _net;
+    uint32_t _boots;
+    size_t _lastLeak;
+    sim::HeapStats _lastBootHeap;
+};
@@ -0,0 +1,245 @@
+// Per-request cost of every web endpoint: response bytes and heap traffic of
+// the HTML portal next to the JSON API, measured on the real handlers. Exit
+// status is non-zero if a request returns an unexpected status, reboots when
+// it should not (or the reverse), or leaves heap allocated behind.
+#include "SimDevice.h"
+#include "SimBoard.h"
+#include "SimHeap.h"
+#include <WebServer.h>
+#include <WiFi.h>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Repeats per request after warm-up; the first requests also fill the TIME_WAIT pool
+const int WARMUP = 4;
+const int ITERATIONS = 16;
+const int SCAN_SIZE = 12;
+const uint32_t CONNECT_TIMEOUT_MS = 30000;
+const uint32_t LOOP_STEP_MS = 10;
+
+typedef std::vector<std::pair<std::string, std::string>> Args;
+
+struct Sample {
+    int code;
+    bool rebooted;
+    size_t bodyBytes;
+    size_t wireBytes;
+    uint32_t writes;
+    uint64_t allocs;        // malloc + realloc
+    uint64_t frees;
+    size_t peak;            // heap in use above the level before the request
+    size_t largestRequest;
+    long held;              // heap still in use after the request, vs. before
+};
+
+struct Row {
+    std::string label;
+    int runs;
+    Sample total;
+};
+
+class Bench {
+public:
+    int run();
+
+private:
+    SimDevice _device;
+    std::vector<Row> _rows;
+    std::vector<std::string> _failures;
+    std::string _configJson;
+
+    Sample serve(const sim::HttpRequest& request);
+    void measure(const char* label, const sim::HttpRequest& request, int expectCode);
+    void measureReboot(const char* label, const sim::HttpRequest& request);
+    bool waitConnected();
+    void report();
+};
+
+sim::HttpRequest get(const char* uri) {
+    sim::HttpRequest r;
+    r.method = HTTP_GET;
+    r.uri = uri;
+    r.host = "10.0.0.42";
+    return r;
+}
+
+sim::HttpRequest postJson(const std::string& body) {
+    sim::HttpRequest r;
+    r.method = HTTP_POST;
+    r.uri = "/api/config";
+    r.body = body;
+    r.contentType = "application/json";
+    r.host = "10.0.0.42";
+    return r;
+}
+
+sim::HttpRequest postForm(const Args& args) {
+    sim::HttpRequest r;
+    r.method = HTTP_POST;
+    r.uri = "/save";
+    r.args = args;
+    r.host = "192.168.1.1";
+    return r;
+}
+
+// One request through one pass of the firmware loop. A restart is caught here
+// rather than in SimDevice::loop() so the heap counters survive until read.
+Sample Bench::serve(const sim::HttpRequest& request) {
+    Sample s = Sample();
+    size_t before = sim::heapStats().used;
+    sim::httpSubmit(request);
+    sim::heapWindowBegin();
+    try {
+        _device.net().update();
+        _device.blinker().update();
+    } catch (const sim::Restart&) {
+        s.rebooted = true;
+    }
+
+    const sim::HeapStats& h = sim::heapWindow();
+    const sim::HttpResponse& r = sim::httpLastResponse();
+    s.code = r.code;
+    s.bodyBytes = r.body.size();
+    s.wireBytes = r.wireBytes;
+    s.writes = r.writes;
+    s.allocs = h.allocs + h.reallocs;
+    s.frees = h.frees;
+    s.peak = h.peakUsed - before;
+    s.largestRequest = h.largestRequest;
+    s.held = (long)h.used - (long)before;
+
+    if (s.rebooted) {
+        _device.shutdown();
+        _device.boot();
+    }
+    return s;
+}
+
+void Bench::measure(const char* label, const sim::HttpRequest& request, int expectCode) {
+    for (int i = 0; i < WARMUP; i++) serve(request);
+
+    Row row = Row();
+    row.label = label;
+    for (int i = 0; i < ITERATIONS; i++) {
+        Sample s = serve(request);
+        if (s.rebooted) {
+            _failures.push_back(std::string(label) + ": rebooted");
+            return;
+        }
+        if (s.code != expectCode) {
+            _failures.push_back(std::string(label) + ": returned " + std::to_string(s.code) +
+                                ", expected " + std::to_string(expectCode));
+        }
+        if (s.held != 0) {
+            _failures.push_back(std::string(label) + ": " + std::to_string(s.held) + " heap bytes held after warm-up");
+        }
+        row.runs++;
+        row.total.bodyBytes += s.bodyBytes;
+        row.total.wireBytes += s.wireBytes;
+        row.total.writes += s.writes;
+        row.total.allocs += s.allocs;
+        row.total.frees += s.frees;
+        if (s.peak > row.total.peak) row.total.peak = s.peak;
+        if (s.largestRequest > row.total.largestRequest) row.total.largestRequest = s.largestRequest;
+        row.total.code = s.code;
+    }
+    _rows.push_back(row);
+}
+
+void Bench::measureReboot(const char* label, const sim::HttpRequest& request) {
+    // Single shot: allocations up to the restart, which then discards the heap
+    Row row = Row();
+    row.label = label;
+    row.runs = 1;
+    row.total = serve(request);
+    if (!row.total.rebooted) _failures.push_back(std::string(label) + ": did not reboot");
+    _rows.push_back(row);
+}
+
+bool Bench::waitConnected() {
+    for (uint32_t t = 0; t < CONNECT_TIMEOUT_MS; t += LOOP_STEP_MS) {
+        if (_device.net().isConnected()) return true;
+        _device.loop();
+        sim::advance(LOOP_STEP_MS);
+    }
+    return false;
+}
+
+int Bench::run() {
+    // Factory state: no SSID, so the portal comes up in AP mode and scans
+    sim::nvsErase();
+    _device.boot();
+    sim::wifiSetScanSize(SCAN_SIZE);
+    measure("GET / (AP, scan)", get("/"), 200);
+    measureReboot("POST /save", postForm({{"ssid", "HomeNetwork"}, {"pass", "correct horse battery"}, {"dhcp", "on"}}));
+
+    if (!waitConnected()) {
+        fprintf(stderr, "device did not connect after provisioning\n");
+        return 1;
+    }
+
+    measure("GET / (STA)", get("/"), 200);
+    measure("GET /api/status", get("/api/status"), 200);
+    measure("GET /api/config", get("/api/config"), 200);
+
+    // A fetched document posted back unchanged must neither save nor reboot
+    serve(get("/api/config"));
+    _configJson = sim::httpLastResponse().body;
+    measure("POST /api/config same", postJson(_configJson), 200);
+    measure("POST /api/config {}", postJson("{}"), 200);
+    measure("POST /api/config bad", postJson("{\"ip\":\"10.0.0.300\"}"), 400);
+    measure("POST /api/config 2KB", postJson("{\"ssid\":\"" + std::string(2048, 'x') + "\"}"), 413);
+    // curl -d default: the server parses the body as a form, so no "plain" argument
+    sim::HttpRequest form = postJson("{\"ssid\":\"OtherNetwork\"}");
+    form.contentType = "application/x-www-form-urlencoded";
+    measure("POST /api/config form", form, 400);
+    measureReboot("POST /api/config", postJson("{\"ssid\":\"OtherNetwork\",\"pass\":\"correct horse battery\"}"));
+
+    report();
+    return _failures.empty() ? 0 : 1;
+}
+
+void Bench::report() {
+    printf("%d requests per row after %d warm-up, %d scan results, heap arena %zu bytes\n\n", ITERATIONS, WARMUP,
+           SCAN_SIZE, sim::HEAP_ARENA_SIZE);
+    printf("%-22s %4s %6s %6s %6s %7s %6s %6s %6s\n", "request", "code", "body", "wire", "writes", "allocs", "frees",
+           "peak", "maxreq");
+    for (const Row& r : _rows) {
+        const Sample& t = r.total;
+        printf("%-22s %4d %6.0f %6.0f %6.1f %7.1f %6.1f %6zu %6zu%s\n", r.label.c_str(), t.code,
+               (double)t.bodyBytes / r.runs, (double)t.wireBytes / r.runs, (double)t.writes / r.runs,
+               (double)t.allocs / r.runs, (double)t.frees / r.runs, t.peak, t.largestRequest,
+               t.rebooted ? "  (reboots)" : "");
+    }
+    printf("body = response payload, wire = everything written to the socket (status line,\n"
+           "headers, chunk framing), allocs = malloc + realloc, peak = most heap in use above\n"
+           "the level before the request, maxreq = largest single allocation. Values are\n"
+           "per request; rows that reboot are a single request up to ESP.restart().\n");
+
+    if (_failures.empty()) {
+        printf("\nPASS\n");
+    } else {
+        printf("\nFAIL: %zu violations\n", _failures.size());
+        for (const std::string& f : _failures) printf("  %s\n", f.c_str());
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--serial") == 0) {
+            sim::setSerialEcho(true);
+        } else {
+            fprintf(stderr, "usage: %s [--serial]\n", argv[0]);
+            return 2;
+        }
+    }
+    Bench bench;
+    return bench.run();
+}
@@ -0,0 +1,265 @@
+// Table-driven checks of the JSON API codec: JsonReader against input /
+// expected-error pairs (the API-002 and API-005 rules), and JsonWriter output
+// parsed back by JsonReader. Exit status is non-zero on any mismatch.
+#include "JsonReader.h"
+#include "JsonWriter.h"
+#include <WebServer.h>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct ReaderCase {
+    const char* name;
+    std::string input;
+    const char* error;      // expected error, nullptr if the input must parse
+    const char* ssid;       // expected decoded ssid when it parses, nullptr to skip
+};
+
+// Same field shapes as handleApiConfigSave()
+struct ConfigFields {
+    char ssid[33], pass[65], ip[16];
+    bool dhcp;
+    JsonField fields[5];
+
+    ConfigFields()
+        : dhcp(false),
+          fields{
+              {"ssid",        JSON_STRING, ssid,    sizeof(ssid), nullptr, false},
+              {"pass",        JSON_STRING, pass,    sizeof(pass), nullptr, false},
+              {"dhcp",        JSON_BOOL,   nullptr, 0,            &dhcp,   false},
+              {"ip",          JSON_STRING, ip,      sizeof(ip),   nullptr, false},
+              {"device_name", JSON_IGNORE, nullptr, 0,            nullptr, false},
+          } {
+        ssid[0] = pass[0] = ip[0] = '\0';
+    }
+    size_t count() const { return sizeof(fields) / sizeof(fields[0]); }
+};
+
+const std::vector<ReaderCase> READER_CASES = {
+    // Accepted
+    {"empty object",          "{}", nullptr, ""},
+    {"all kinds",             " {\"ssid\" : \"Home\", \"dhcp\":false,\"ip\":\"10.0.0.2\"}\r\n", nullptr, "Home"},
+    {"simple escapes",        "{\"ssid\":\"a\\\"b\\\\c\\/d\\n\"}", nullptr, "a\"b\\c/d\n"},
+    {"ascii \\u escape",      "{\"ssid\":\"\\u0041\\u0001\"}", nullptr, "A\x01"},
+    {"2-byte \\u escape",     "{\"ssid\":\"Caf\\u00e9\"}", nullptr, "Caf\xC3\xA9"},
+    {"3-byte \\u escape",     "{\"ssid\":\"\\u20AC\"}", nullptr, "\xE2\x82\xAC"},
+    {"surrogate pair",        "{\"ssid\":\"\\ud83d\\ude00\"}", nullptr, "\xF0\x9F\x98\x80"},
+    {"raw utf-8",             "{\"ssid\":\"Caf\xC3\xA9\"}", nullptr, "Caf\xC3\xA9"},
+    {"32-byte ssid",          "{\"ssid\":\"" + std::string(32, 'a') + "\"}", nullptr, nullptr},
+    {"30 + 2-byte escape",    "{\"ssid\":\"" + std::string(30, 'a') + "\\u00e9\"}", nullptr, nullptr},
+    {"ignored string",        "{\"device_name\":\"x\\u00e9\"}", nullptr, nullptr},
+    {"ignored number",        "{\"device_name\":-12.5e+3}", nullptr, nullptr},
+    {"ignored zero",          "{\"device_name\":0}", nullptr, nullptr},
+    {"ignored bool",          "{\"device_name\":true}", nullptr, nullptr},
+    {"ignored null",          "{\"device_name\":null}", nullptr, nullptr},
+
+    // Structure
+    {"not an object",         "[]", "Expected object", nullptr},
+    {"empty input",           "", "Expected object", nullptr},
+    {"trailing data",         "{\"ssid\":\"a\"} x", "Trailing data", nullptr},
+    {"trailing comma",        "{\"ssid\":\"a\",}", "Expected string", nullptr},
+    {"missing colon",         "{\"ssid\" \"a\"}", "Expected ':'", nullptr},
+    {"missing comma",         "{\"ssid\":\"a\" \"pass\":\"b\"}", "Expected ',' or '}'", nullptr},
+    {"unterminated object",   "{\"ssid\":\"a\"", "Expected ',' or '}'", nullptr},
+    {"body too large",        "{\"ssid\":\"" + std::string(JsonReader::MAX_INPUT, 'a') + "\"}", "Body too large", nullptr},
+
+    // Keys
+    {"unknown key",           "{\"foo\":\"x\"}", "Unknown key", nullptr},
+    {"over-long key",         "{\"" + std::string(JsonReader::MAX_KEY, 'k') + "\":\"x\"}", "Unknown key", nullptr},
+    {"duplicate key",         "{\"ssid\":\"a\",\"ssid\":\"b\"}", "Duplicate key", nullptr},
+    {"duplicate ignored key", "{\"device_name\":1,\"device_name\":2}", "Duplicate key", nullptr},
+    {"unquoted key",          "{ssid:\"a\"}", "Expected string", nullptr},
+
+    // Values
+    {"object for string",     "{\"ssid\":{\"a\":\"b\"}}", "Expected string", nullptr},
+    {"nested ignored object", "{\"device_name\":{}}", "Nested values not supported", nullptr},
+    {"nested ignored array",  "{\"device_name\":[1]}", "Nested values not supported", nullptr},
+    {"number for string",     "{\"ssid\":1}", "Expected string", nullptr},
+    {"string for dhcp",       "{\"dhcp\":\"true\"}", "Expected boolean", nullptr},
+    {"number for dhcp",       "{\"dhcp\":1}", "Expected boolean", nullptr},
+    {"null for dhcp",         "{\"dhcp\":null}", "Expected boolean", nullptr},
+    {"leading zero",          "{\"device_name\":01}", "Expected ',' or '}'", nullptr},
+    {"bare minus",            "{\"device_name\":-}", "Invalid number", nullptr},
+    {"bad fraction",          "{\"device_name\":1.}", "Invalid number", nullptr},
+    {"bad literal",           "{\"device_name\":nul}", "Expected value", nullptr},
+    {"33-byte ssid",          "{\"ssid\":\"" + std::string(33, 'a') + "\"}", "Value too long", nullptr},
+    {"31 + 2-byte escape",    "{\"ssid\":\"" + std::string(31, 'a') + "\\u00e9\"}", "Value too long", nullptr},
+    {"16-char ip",            "{\"ip\":\"192.168.100.2000\"}", "Value too long", nullptr},
+
+    // Strings
+    {"unterminated string",   "{\"ssid\":\"abc", "Unterminated string", nullptr},
+    {"raw control character", "{\"ssid\":\"a\x01\"}", "Control character in string", nullptr},
+    {"unknown escape",        "{\"ssid\":\"a\\q\"}", "Invalid escape", nullptr},
+    {"bad hex digit",         "{\"ssid\":\"\\u00G0\"}", "Invalid escape", nullptr},
+    {"short \\u escape",      "{\"ssid\":\"\\u00\"}", "Invalid escape", nullptr},
+    {"\\u0000",               "{\"ssid\":\"\\u0000\"}", "Unsupported escape", nullptr},
+    {"lone low surrogate",    "{\"ssid\":\"\\udc00\"}", "Invalid surrogate", nullptr},
+    {"lone high surrogate",   "{\"ssid\":\"\\ud83d\"}", "Invalid surrogate", nullptr},
+    {"high + non-surrogate",  "{\"ssid\":\"\\ud83d\\u0041\"}", "Invalid surrogate", nullptr},
+    {"high + plain text",     "{\"ssid\":\"\\ud83dxxxxxx\"}", "Invalid surrogate", nullptr},
+    {"bad ignored string",    "{\"device_name\":\"\\ud800\"}", "Invalid surrogate", nullptr},
+};
+
+// Strings written by JsonWriter and read back by JsonReader
+const std::vector<std::string> ROUND_TRIP = {
+    "",
+    "HomeNetwork",
+    "quote \" backslash \\ slash /",
+    "\b\f\n\r\t",
+    std::string("\x01\x1f", 2),
+    "Caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80",
+    std::string(32, 'x'),
+};
+
+class JsonTest {
+public:
+    JsonTest();
+    int run();
+
+private:
+    WebServer _server;
+    std::function<void(JsonWriter&)> _write;
+    uint32_t _cases = 0;
+    std::vector<std::string> _failures;
+
+    void expect(bool ok, const std::string& what);
+    std::string render(std::function<void(JsonWriter&)> write);
+    void readerCases();
+    void writerOutput();
+    void roundTrip();
+};
+
+void JsonTest::expect(bool ok, const std::string& what) {
+    _cases++;
+    if (!ok) _failures.push_back(what);
+}
+
+std::string quoted(const std::string& s) {
+    std::string out;
+    for (unsigned char c : s) {
+        char buf[5];
+        if (c < 0x20 || c >= 0x7F || c == '\\') {
+            snprintf(buf, sizeof(buf), "\\x%02x", c);
+            out += buf;
+        } else {
+            out += (char)c;
+        }
+    }
+    return out.size() > 60 ? out.substr(0, 57) + "..." : out;
+}
+
+JsonTest::JsonTest() {
+    _server.on("/json", HTTP_GET, [this]() {
+        JsonWriter json(_server);
+        json.begin(200);
+        _write(json);
+        json.end();
+    });
+}
+
+// Runs write inside a real request so JsonWriter goes through WebServer's chunked path
+std::string JsonTest::render(std::function<void(JsonWriter&)> write) {
+    _write = write;
+    sim::HttpRequest r;
+    r.method = HTTP_GET;
+    r.uri = "/json";
+    r.host = "10.0.0.42";
+    sim::httpSubmit(r);
+    _server.handleClient();
+    return sim::httpLastResponse().body;
+}
+
+void JsonTest::readerCases() {
+    for (const ReaderCase& c : READER_CASES) {
+        ConfigFields f;
+        JsonReader reader(c.input.data(), c.input.size());
+        bool ok = reader.parseObject(f.fields, f.count());
+        const char* error = ok ? nullptr : reader.error();
+
+        if (c.error) {
+            expect(!ok && strcmp(error, c.error) == 0, std::string("reader: ") + c.name + ": expected \"" + c.error +
+                   "\", got " + (ok ? "success" : "\"" + std::string(error) + "\""));
+        } else if (!ok) {
+            expect(false, std::string("reader: ") + c.name + ": expected success, got \"" + error + "\"");
+        } else if (c.ssid) {
+            expect(strcmp(f.ssid, c.ssid) == 0, std::string("reader: ") + c.name + ": decoded \"" + quoted(f.ssid) +
+                   "\", expected \"" + quoted(c.ssid) + "\"");
+        } else {
+            expect(true, c.name);
+        }
+    }
+}
+
+void JsonTest::writerOutput() {
+    std::string out = render([](JsonWriter& json) {
+        json.beginObject();
+        json.key("s"); json.value("a\"b\\c\x01\n");
+        json.key("t"); json.value(true);
+        json.key("f"); json.value(false);
+        json.key("n"); json.nullValue();
+        json.key("i"); json.value((int32_t)-2147483647 - 1);
+        json.key("u"); json.value((uint32_t)4294967295u);
+        json.key("o");
+        json.beginObject();
+        json.key("e"); json.beginObject(); json.endObject();
+        json.key("k"); json.value("v");
+        json.endObject();
+        json.endObject();
+    });
+    const char* expected = "{\"s\":\"a\\\"b\\\\c\\u0001\\n\",\"t\":true,\"f\":false,\"n\":null,"
+                           "\"i\":-2147483648,\"u\":4294967295,\"o\":{\"e\":{},\"k\":\"v\"}}";
+    expect(out == expected, "writer: got " + quoted(out));
+    expect(sim::httpLastResponse().contentType == "application/json", "writer: content type " +
+           sim::httpLastResponse().contentType);
+
+    // Longer than the chunk buffer, so the output spans several chunks
+    std::string longValue(1000, 'z');
+    out = render([&](JsonWriter& json) {
+        json.beginObject();
+        json.key("ssid"); json.value(longValue.c_str());
+        json.endObject();
+    });
+    expect(out == "{\"ssid\":\"" + longValue + "\"}", "writer: multi-chunk output corrupted");
+}
+
+void JsonTest::roundTrip() {
+    for (const std::string& s : ROUND_TRIP) {
+        std::string out = render([&](JsonWriter& json) {
+            json.beginObject();
+            json.key("ssid"); json.value(String(s.c_str()));
+            json.key("dhcp"); json.value(true);
+            json.endObject();
+        });
+        ConfigFields f;
+        JsonReader reader(out.data(), out.size());
+        bool ok = reader.parseObject(f.fields, f.count());
+        expect(ok && f.dhcp && f.ssid == s, "round trip: \"" + quoted(s) + "\" -> " + quoted(out) +
+               (ok ? " -> \"" + quoted(f.ssid) + "\"" : " -> " + std::string(reader.error())));
+    }
+}
+
+int JsonTest::run() {
+    readerCases();
+    writerOutput();
+    roundTrip();
+
+    printf("%u cases\n", _cases);
+    if (_failures.empty()) {
+        printf("\nPASS\n");
+        return 0;
+    }
+    printf("\nFAIL: %zu mismatches\n", _failures.size());
+    for (const std::string& f : _failures) printf("  %s\n", f.c_str());
+    return 1;
+}
+
+}
+
+int main() {
+    JsonTest test;
+    return test.run();
+}
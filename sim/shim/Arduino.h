@@ -0,0 +1,38 @@
+#pragma once
+// Host shim of the Arduino-ESP32 core, just large enough to compile the
+// firmware sources unchanged. See sim/README.md for what is modelled.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+#include "WString.h"
+#include "IPAddress.h"
+#include "Print.h"
+#include "Esp.h"
+
+#define PROGMEM
+#define PGM_P const char*
+#define strlen_P strlen
+#define memcpy_P memcpy
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+// ESP32 millis() is a 32-bit unsigned long; uint32_t keeps that width on 64-bit hosts
+uint32_t millis();
+void delay(uint32_t ms);
+void yield();
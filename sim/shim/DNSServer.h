@@ -0,0 +1,16 @@
+#pragma once
+#include "Arduino.h"
+
+class DNSServer {
+public:
+    bool start(const uint16_t& port, const String& domainName, const IPAddress& resolvedIP) {
+        (void)port; (void)domainName; (void)resolvedIP;
+        _started = true;
+        return true;
+    }
+    void stop() { _started = false; }
+    void processNextRequest() {}
+
+private:
+    bool _started = false;
+};
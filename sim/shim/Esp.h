@@ -0,0 +1,14 @@
+#pragma once
+#include <cstdint>
+
+class EspClass {
+public:
+    // Unwinds to the simulated boot loop by throwing sim::Restart
+    [[noreturn]] void restart();
+    uint32_t getFreeSketchSpace();
+    uint32_t getFreeHeap();
+    uint32_t getMaxAllocHeap();
+    uint64_t getEfuseMac();
+};
+
+extern EspClass ESP;
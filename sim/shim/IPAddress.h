@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+#include "WString.h"
+
+class IPAddress {
+public:
+    IPAddress() : _bytes{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _bytes{a, b, c, d} {}
+
+    bool fromString(const char* address);
+    bool fromString(const String& address) { return fromString(address.c_str()); }
+    String toString() const;
+
+    uint8_t operator[](int index) const { return _bytes[index]; }
+    uint8_t& operator[](int index) { return _bytes[index]; }
+    bool operator ==(const IPAddress& rhs) const;
+    bool operator !=(const IPAddress& rhs) const { return !(*this == rhs); }
+
+private:
+    uint8_t _bytes[4];
+};
@@ -0,0 +1,70 @@
+#include "Preferences.h"
+#include <map>
+#include <string>
+
+namespace sim {
+
+namespace {
+
+std::map<std::string, std::string> nvs;
+uint32_t writes = 0;
+
+bool lookup(const char* key, std::string& value) {
+    auto it = nvs.find(key);
+    if (it == nvs.end()) return false;
+    value = it->second;
+    return true;
+}
+
+size_t store(const char* key, const std::string& value) {
+    writes++;
+    nvs[key] = value;
+    return value.size();
+}
+
+}
+
+uint32_t nvsWrites() { return writes; }
+
+void nvsErase() {
+    nvs.clear();
+    writes = 0;
+}
+
+}
+
+bool Preferences::begin(const char*, bool, const char*) { return true; }
+void Preferences::end() {}
+
+bool Preferences::clear() {
+    sim::nvs.clear();
+    return true;
+}
+
+size_t Preferences::putBool(const char* key, bool value) { return sim::store(key, value ? "1" : "0"); }
+size_t Preferences::putUShort(const char* key, uint16_t value) { return sim::store(key, std::to_string(value)); }
+size_t Preferences::putUInt(const char* key, uint32_t value) { return sim::store(key, std::to_string(value)); }
+size_t Preferences::putString(const char* key, const char* value) { return sim::store(key, value); }
+size_t Preferences::putString(const char* key, String value) { return sim::store(key, value.c_str()); }
+
+bool Preferences::getBool(const char* key, bool defaultValue) {
+    std::string v;
+    return sim::lookup(key, v) ? v == "1" : defaultValue;
+}
+
+uint16_t Preferences::getUShort(const char* key, uint16_t defaultValue) {
+    std::string v;
+    return sim::lookup(key, v) ? (uint16_t)std::stoul(v) : defaultValue;
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) {
+    std::string v;
+    return sim::lookup(key, v) ? (uint32_t)std::stoul(v) : defaultValue;
+}
+
+String Preferences::getString(const char* key, String defaultValue) {
+    std::string v;
+    // Arduino-ESP32 reads into a stack buffer and returns String(buf)
+    if (!sim::lookup(key, v)) return defaultValue;
+    return String(v.c_str());
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "Arduino.h"
+
+// NVS-backed key/value store. Values live in host memory (flash on the
+// device); only the Strings handed to and returned from the API touch the
+// simulated heap. Signatures follow Arduino-ESP32, including String by value.
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false, const char* partition_label = nullptr);
+    void end();
+    bool clear();
+
+    size_t putBool(const char* key, bool value);
+    size_t putUShort(const char* key, uint16_t value);
+    size_t putUInt(const char* key, uint32_t value);
+    size_t putString(const char* key, const char* value);
+    size_t putString(const char* key, String value);
+
+    bool getBool(const char* key, bool defaultValue = false);
+    uint16_t getUShort(const char* key, uint16_t defaultValue = 0);
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+    String getString(const char* key, String defaultValue = String());
+};
+
+namespace sim {
+
+// Number of NVS writes since the last reset (flash wear indicator)
+uint32_t nvsWrites();
+// Erases the simulated flash
+void nvsErase();
+
+}
@@ -0,0 +1,122 @@
+#include "Arduino.h"
+#include "SimBoard.h"
+#include "SimHeap.h"
+#include <cstdarg>
+
+HardwareSerial Serial;
+EspClass ESP;
+
+namespace sim {
+
+namespace {
+
+const int PIN_COUNT = 64;
+
+uint32_t clockMs = 0;
+uint8_t modes[PIN_COUNT];
+uint8_t levels[PIN_COUNT];
+std::function<int(uint8_t)> inputSource;
+std::function<void(uint8_t, int)> pinChangeHook;
+bool serialEcho = false;
+
+}
+
+uint32_t now() { return clockMs; }
+void setNow(uint32_t ms) { clockMs = ms; }
+void advance(uint32_t ms) { clockMs += ms; }
+
+int pinLevel(uint8_t pin) { return pin < PIN_COUNT ? levels[pin] : LOW; }
+void setInputSource(std::function<int(uint8_t)> source) { inputSource = source; }
+void setPinChangeHook(std::function<void(uint8_t, int)> hook) { pinChangeHook = hook; }
+
+void resetPins() {
+    memset(modes, 0, sizeof(modes));
+    memset(levels, 0, sizeof(levels));
+}
+
+void setSerialEcho(bool echo) { serialEcho = echo; }
+
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < sim::PIN_COUNT) sim::modes[pin] = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin >= sim::PIN_COUNT) return;
+    int level = val ? HIGH : LOW;
+    if (sim::levels[pin] == level) return;
+    sim::levels[pin] = level;
+    if (sim::pinChangeHook) sim::pinChangeHook(pin, level);
+}
+
+int digitalRead(uint8_t pin) {
+    if (pin >= sim::PIN_COUNT) return LOW;
+    // Output pins read back their driven level, as on the ESP32
+    if (sim::modes[pin] == OUTPUT) return sim::levels[pin];
+    if (sim::inputSource) return sim::inputSource(pin);
+    return sim::modes[pin] == INPUT_PULLUP ? HIGH : LOW;
+}
+
+uint32_t millis() { return sim::clockMs; }
+void delay(uint32_t ms) { sim::clockMs += ms; }
+void yield() {}
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+    return write(reinterpret_cast<const uint8_t*>(buf), (size_t)len < sizeof(buf) ? len : sizeof(buf) - 1);
+}
+
+size_t Print::print(int n) { return printf("%d", n); }
+size_t Print::print(unsigned int n) { return printf("%u", n); }
+size_t Print::print(long n) { return printf("%ld", n); }
+size_t Print::print(unsigned long n) { return printf("%lu", n); }
+size_t Print::print(const IPAddress& ip) { return printf("%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]); }
+
+size_t HardwareSerial::write(uint8_t c) {
+    if (sim::serialEcho) fputc(c, stdout);
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    if (sim::serialEcho) fwrite(buffer, 1, size, stdout);
+    return size;
+}
+
+bool IPAddress::fromString(const char* address) {
+    unsigned int parts[4];
+    char tail;
+    if (sscanf(address, "%u.%u.%u.%u%c", &parts[0], &parts[1], &parts[2], &parts[3], &tail) != 4) return false;
+    for (int i = 0; i < 4; i++) {
+        if (parts[i] > 255) return false;
+        _bytes[i] = parts[i];
+    }
+    return true;
+}
+
+String IPAddress::toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _bytes[0], _bytes[1], _bytes[2], _bytes[3]);
+    return String(buf);
+}
+
+bool IPAddress::operator ==(const IPAddress& rhs) const {
+    return memcmp(_bytes, rhs._bytes, sizeof(_bytes)) == 0;
+}
+
+void EspClass::restart() { throw sim::Restart(); }
+uint32_t EspClass::getFreeSketchSpace() { return 1310720; }
+uint32_t EspClass::getFreeHeap() { return sim::heapFreeBytes(); }
+uint32_t EspClass::getMaxAllocHeap() { return sim::heapLargestFreeBlock(); }
+uint64_t EspClass::getEfuseMac() { return 0x0000A1B2C3D4E5F6ULL; }
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+// Simulated board state shared by the shims: clock, GPIO and reboot.
+namespace sim {
+
+// Thrown by ESP.restart(); the harness catches it and reboots the device
+struct Restart {};
+
+uint32_t now();
+void setNow(uint32_t ms);
+void advance(uint32_t ms);
+
+// Level last written to an output pin
+int pinLevel(uint8_t pin);
+// Provides the level of input pins (e.g. the config button), evaluated on every digitalRead()
+void setInputSource(std::function<int(uint8_t pin)> source);
+// Called on every digitalWrite() that changes an output level
+void setPinChangeHook(std::function<void(uint8_t pin, int level)> hook);
+void resetPins();
+
+void setSerialEcho(bool echo);
+
+}
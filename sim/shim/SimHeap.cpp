@@ -0,0 +1,201 @@
+#include "SimHeap.h"
+#include <cstring>
+#include <initializer_list>
+
+namespace sim {
+
+namespace {
+
+struct Block {
+    uint32_t size;  // including header
+    uint32_t used;
+};
+
+const size_t ALIGN = 8;
+const size_t HEADER = sizeof(Block);
+const size_t MIN_BLOCK = HEADER + ALIGN;
+
+alignas(16) uint8_t arena[HEAP_ARENA_SIZE];
+bool initialized = false;
+HeapStats stats;
+HeapStats window;
+
+void startStats(HeapStats& s, size_t largestFree) {
+    memset(&s, 0, sizeof(s));
+    s.used = s.peakUsed = stats.used;
+    s.minLargestFree = largestFree;
+}
+
+Block* first() { return reinterpret_cast<Block*>(arena); }
+Block* next(Block* b) { return reinterpret_cast<Block*>(reinterpret_cast<uint8_t*>(b) + b->size); }
+bool inArena(Block* b) { return reinterpret_cast<uint8_t*>(b) < arena + HEAP_ARENA_SIZE; }
+Block* header(void* p) { return reinterpret_cast<Block*>(static_cast<uint8_t*>(p) - HEADER); }
+void* payload(Block* b) { return reinterpret_cast<uint8_t*>(b) + HEADER; }
+
+size_t blockSizeFor(size_t size) {
+    size_t total = (size + HEADER + ALIGN - 1) & ~(ALIGN - 1);
+    return total < MIN_BLOCK ? MIN_BLOCK : total;
+}
+
+void ensureInit() {
+    if (initialized) return;
+    initialized = true;
+    first()->size = HEAP_ARENA_SIZE;
+    first()->used = 0;
+    stats.used = 0;
+    startStats(stats, HEAP_ARENA_SIZE - HEADER);
+    startStats(window, HEAP_ARENA_SIZE - HEADER);
+}
+
+// Merges b with the free blocks that follow it
+void coalesce(Block* b) {
+    Block* n = next(b);
+    while (inArena(n) && !n->used) {
+        b->size += n->size;
+        n = next(b);
+    }
+}
+
+void split(Block* b, size_t size) {
+    if (b->size - size >= MIN_BLOCK) {
+        Block* rest = reinterpret_cast<Block*>(reinterpret_cast<uint8_t*>(b) + size);
+        rest->size = b->size - size;
+        rest->used = 0;
+        b->size = size;
+    }
+}
+
+size_t largestFree();
+
+// Called after every successful allocation
+void noteUsage() {
+    size_t largest = largestFree();
+    for (HeapStats* s : {&stats, &window}) {
+        s->used = stats.used;
+        if (s->used > s->peakUsed) s->peakUsed = s->used;
+        if (largest < s->minLargestFree) s->minLargestFree = largest;
+    }
+}
+
+void noteRequest(size_t size) {
+    if (size > stats.largestRequest) stats.largestRequest = size;
+    if (size > window.largestRequest) window.largestRequest = size;
+}
+
+void release(Block* b) {
+    stats.used -= b->size;
+    window.used = stats.used;
+    b->used = 0;
+    coalesce(b);
+}
+
+void* allocate(size_t size) {
+    noteRequest(size);
+    size_t need = blockSizeFor(size);
+    for (Block* b = first(); inArena(b); b = next(b)) {
+        if (b->used) continue;
+        coalesce(b);
+        if (b->size >= need) {
+            split(b, need);
+            b->used = 1;
+            stats.used += b->size;
+            noteUsage();
+            return payload(b);
+        }
+    }
+    stats.failures++;
+    window.failures++;
+    return nullptr;
+}
+
+size_t largestFree() {
+    size_t largest = 0;
+    for (Block* b = first(); inArena(b); b = next(b)) {
+        if (b->used) continue;
+        coalesce(b);
+        if (b->size - HEADER > largest) largest = b->size - HEADER;
+    }
+    return largest;
+}
+
+}
+
+void heapReset() {
+    initialized = false;
+    ensureInit();
+}
+
+void* heapMalloc(size_t size) {
+    ensureInit();
+    stats.allocs++;
+    window.allocs++;
+    return allocate(size);
+}
+
+void* heapRealloc(void* ptr, size_t size) {
+    ensureInit();
+    if (!ptr) return heapMalloc(size);
+    stats.reallocs++;
+    window.reallocs++;
+    
+    Block* b = header(ptr);
+    size_t need = blockSizeFor(size);
+    noteRequest(size);
+    if (b->size >= need) return ptr;
+    
+    // Grow in place when the following blocks are free
+    Block* n = next(b);
+    if (inArena(n) && !n->used) {
+        size_t old = b->size;
+        coalesce(n);
+        if (b->size + n->size >= need) {
+            b->size += n->size;
+            split(b, need);
+            stats.used += b->size - old;
+            noteUsage();
+            return ptr;
+        }
+    }
+    
+    void* moved = allocate(size);
+    if (!moved) return nullptr;
+    stats.moves++;
+    window.moves++;
+    memcpy(moved, ptr, b->size - HEADER);
+    release(b);
+    return moved;
+}
+
+void heapFree(void* ptr) {
+    if (!ptr) return;
+    stats.frees++;
+    window.frees++;
+    release(header(ptr));
+}
+
+size_t heapFreeBytes() {
+    ensureInit();
+    return HEAP_ARENA_SIZE - stats.used;
+}
+
+size_t heapLargestFreeBlock() {
+    ensureInit();
+    return largestFree();
+}
+
+const HeapStats& heapStats() {
+    ensureInit();
+    return stats;
+}
+
+void heapWindowBegin() {
+    ensureInit();
+    startStats(window, largestFree());
+}
+
+const HeapStats& heapWindow() {
+    ensureInit();
+    return window;
+}
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Host model of the ESP32 heap: a fixed arena managed first-fit with block
+// headers and coalescing, so fragmentation (largest free block) is observable.
+// Everything the firmware allocates through String, WebServer, WiFi and the
+// synthetic network stack goes through here; host-side bookkeeping does not.
+namespace sim {
+
+struct HeapStats {
+    uint64_t allocs;        // malloc() calls
+    uint64_t reallocs;      // realloc() calls
+    uint64_t moves;         // realloc() calls that had to copy to a new block
+    uint64_t frees;
+    uint64_t failures;      // requests the arena could not satisfy
+    size_t used;            // bytes in live blocks, headers included
+    size_t peakUsed;
+    size_t minLargestFree;  // lowest largest free block left after any allocation
+    size_t largestRequest;  // biggest single malloc()/realloc() size asked for
+};
+
+const size_t HEAP_ARENA_SIZE = 180 * 1024;
+
+void heapReset();
+void* heapMalloc(size_t size);
+void* heapRealloc(void* ptr, size_t size);
+void heapFree(void* ptr);
+
+size_t heapFreeBytes();
+size_t heapLargestFreeBlock();
+
+// Counters since the last heapReset()
+const HeapStats& heapStats();
+// Counters since the last heapWindowBegin(), for measuring a single request
+void heapWindowBegin();
+const HeapStats& heapWindow();
+
+}
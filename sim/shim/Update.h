@@ -0,0 +1,21 @@
+#pragma once
+#include "Arduino.h"
+
+#define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+
+class UpdateClass {
+public:
+    bool begin(size_t size = UPDATE_SIZE_UNKNOWN) { _size = size; _progress = 0; return true; }
+    size_t write(uint8_t* data, size_t len) { (void)data; _progress += len; return len; }
+    bool end(bool evenIfRemaining = false) { (void)evenIfRemaining; return true; }
+    bool hasError() { return false; }
+    void printError(Print& out) { out.println("Update error"); }
+    size_t progress() { return _progress; }
+    size_t size() { return _size; }
+
+private:
+    size_t _size = 0;
+    size_t _progress = 0;
+};
+
+extern UpdateClass Update;
@@ -0,0 +1,222 @@
+#include "WString.h"
+#include "SimHeap.h"
+#include <cstdio>
+#include <cstdlib>
+
+String::String(const char* cstr) {
+    init();
+    if (cstr) copy(cstr, strlen(cstr));
+}
+
+String::String(const char* cstr, unsigned int length) {
+    init();
+    if (cstr) copy(cstr, length);
+}
+
+String::String(const String& str) {
+    init();
+    *this = str;
+}
+
+String::String(const __FlashStringHelper* str) {
+    init();
+    *this = str;
+}
+
+String::String(String&& rval) noexcept {
+    init();
+    move(rval);
+}
+
+String::String(char c) {
+    init();
+    char buf[2] = {c, 0};
+    *this = buf;
+}
+
+#define STRING_FROM_FORMAT(fmt, value) \
+    init();                            \
+    char buf[34];                      \
+    snprintf(buf, sizeof(buf), fmt, value); \
+    *this = buf;
+
+String::String(unsigned char value, unsigned char) { STRING_FROM_FORMAT("%u", (unsigned)value) }
+String::String(int value, unsigned char) { STRING_FROM_FORMAT("%d", value) }
+String::String(unsigned int value, unsigned char) { STRING_FROM_FORMAT("%u", value) }
+String::String(long value, unsigned char) { STRING_FROM_FORMAT("%ld", value) }
+String::String(unsigned long value, unsigned char) { STRING_FROM_FORMAT("%lu", value) }
+
+String::String(float value, unsigned int decimalPlaces) {
+    init();
+    char buf[34];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimalPlaces, (double)value);
+    *this = buf;
+}
+
+String::String(double value, unsigned int decimalPlaces) {
+    init();
+    char buf[34];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimalPlaces, value);
+    *this = buf;
+}
+
+String::~String() {
+    sim::heapFree(_heap);
+}
+
+void String::init() {
+    _heap = nullptr;
+    _cap = SSO_SIZE - 1;
+    _len = 0;
+    _sso[0] = 0;
+}
+
+void String::invalidate() {
+    sim::heapFree(_heap);
+    init();
+}
+
+bool String::reserve(unsigned int size) {
+    if (size <= _cap) return true;
+    return changeBuffer(size);
+}
+
+// Exact-size growth, as in Arduino's String::changeBuffer()
+bool String::changeBuffer(unsigned int maxStrLen) {
+    if (!_heap && maxStrLen < SSO_SIZE) return true;
+    char* newBuffer = static_cast<char*>(sim::heapRealloc(_heap, maxStrLen + 1));
+    if (!newBuffer) return false;
+    if (!_heap) memcpy(newBuffer, _sso, _len + 1);
+    _heap = newBuffer;
+    _cap = maxStrLen;
+    return true;
+}
+
+String& String::copy(const char* cstr, unsigned int length) {
+    if (!reserve(length)) {
+        invalidate();
+        return *this;
+    }
+    memmove(buffer(), cstr, length);
+    _len = length;
+    buffer()[_len] = 0;
+    return *this;
+}
+
+void String::move(String& rhs) {
+    if (this == &rhs) return;
+    sim::heapFree(_heap);
+    if (rhs._heap) {
+        _heap = rhs._heap;
+        _cap = rhs._cap;
+        _len = rhs._len;
+    } else {
+        init();
+        memcpy(_sso, rhs._sso, rhs._len + 1);
+        _len = rhs._len;
+    }
+    rhs.init();
+}
+
+String& String::operator =(const String& rhs) {
+    if (this == &rhs) return *this;
+    return copy(rhs.c_str(), rhs._len);
+}
+
+String& String::operator =(const char* cstr) {
+    if (!cstr) {
+        invalidate();
+        return *this;
+    }
+    return copy(cstr, strlen(cstr));
+}
+
+String& String::operator =(const __FlashStringHelper* str) {
+    return *this = reinterpret_cast<const char*>(str);
+}
+
+String& String::operator =(String&& rval) noexcept {
+    move(rval);
+    return *this;
+}
+
+bool String::concat(const char* cstr, unsigned int length) {
+    if (!cstr) return false;
+    if (length == 0) return true;
+    unsigned int newlen = _len + length;
+    if (!reserve(newlen)) return false;
+    memmove(buffer() + _len, cstr, length);
+    _len = newlen;
+    buffer()[_len] = 0;
+    return true;
+}
+
+bool String::concat(const String& str) {
+    // Appending to itself must not read from a buffer realloc just freed
+    if (&str == this) {
+        unsigned int len = _len;
+        if (!reserve(_len * 2)) return false;
+        memcpy(buffer() + len, buffer(), len);
+        _len = len * 2;
+        buffer()[_len] = 0;
+        return true;
+    }
+    return concat(str.c_str(), str._len);
+}
+
+bool String::concat(const char* cstr) { return cstr && concat(cstr, strlen(cstr)); }
+bool String::concat(char c) { return concat(&c, 1); }
+bool String::concat(const __FlashStringHelper* str) { return concat(reinterpret_cast<const char*>(str)); }
+
+#define CONCAT_FORMAT(fmt, value)                  \
+    char buf[34];                                  \
+    int n = snprintf(buf, sizeof(buf), fmt, value); \
+    return concat(buf, n);
+
+bool String::concat(unsigned char num) { CONCAT_FORMAT("%u", (unsigned)num) }
+bool String::concat(int num) { CONCAT_FORMAT("%d", num) }
+bool String::concat(unsigned int num) { CONCAT_FORMAT("%u", num) }
+bool String::concat(long num) { CONCAT_FORMAT("%ld", num) }
+bool String::concat(unsigned long num) { CONCAT_FORMAT("%lu", num) }
+bool String::concat(float num) { CONCAT_FORMAT("%.2f", (double)num) }
+bool String::concat(double num) { CONCAT_FORMAT("%.2f", num) }
+
+bool String::equals(const char* cstr) const {
+    return strcmp(c_str(), cstr ? cstr : "") == 0;
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+    if (beginIndex > endIndex) {
+        unsigned int t = beginIndex;
+        beginIndex = endIndex;
+        endIndex = t;
+    }
+    if (beginIndex >= _len) return String();
+    if (endIndex > _len) endIndex = _len;
+    return String(c_str() + beginIndex, endIndex - beginIndex);
+}
+
+int String::toInt() const {
+    return atoi(c_str());
+}
+
+StringSumHelper& operator +(const StringSumHelper& lhs, const String& rhs) {
+    StringSumHelper& a = const_cast<StringSumHelper&>(lhs);
+    if (!a.concat(rhs)) a = String();
+    return a;
+}
+
+#define SUM_OPERATOR(type)                                          \
+    StringSumHelper& operator +(const StringSumHelper& lhs, type rhs) { \
+        StringSumHelper& a = const_cast<StringSumHelper&>(lhs);     \
+        a.concat(rhs);                                              \
+        return a;                                                   \
+    }
+
+SUM_OPERATOR(const char*)
+SUM_OPERATOR(char)
+SUM_OPERATOR(int)
+SUM_OPERATOR(unsigned int)
+SUM_OPERATOR(long)
+SUM_OPERATOR(unsigned long)
+SUM_OPERATOR(const __FlashStringHelper*)
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class __FlashStringHelper;
+#define FPSTR(pstr_pointer) (reinterpret_cast<const __FlashStringHelper *>(pstr_pointer))
+#define F(string_literal) (FPSTR(string_literal))
+
+class StringSumHelper;
+
+// Arduino-ESP32 String semantics that matter for heap behaviour: a small
+// inline buffer (SSO), exact-size growth via realloc on every concat, and
+// heap storage from the simulated arena.
+class String {
+public:
+    String(const char* cstr = "");
+    String(const char* cstr, unsigned int length);
+    String(const String& str);
+    String(const __FlashStringHelper* str);
+    String(String&& rval) noexcept;
+    explicit String(char c);
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(float value, unsigned int decimalPlaces = 2);
+    explicit String(double value, unsigned int decimalPlaces = 2);
+    ~String();
+
+    bool reserve(unsigned int size);
+    unsigned int length() const { return _len; }
+    bool isEmpty() const { return _len == 0; }
+    const char* c_str() const { return buffer(); }
+    char operator[](unsigned int index) const { return index < _len ? buffer()[index] : 0; }
+
+    String& operator =(const String& rhs);
+    String& operator =(const char* cstr);
+    String& operator =(const __FlashStringHelper* str);
+    String& operator =(String&& rval) noexcept;
+
+    bool concat(const String& str);
+    bool concat(const char* cstr);
+    bool concat(const char* cstr, unsigned int length);
+    bool concat(char c);
+    bool concat(unsigned char num);
+    bool concat(int num);
+    bool concat(unsigned int num);
+    bool concat(long num);
+    bool concat(unsigned long num);
+    bool concat(float num);
+    bool concat(double num);
+    bool concat(const __FlashStringHelper* str);
+
+    template<typename T> String& operator +=(const T& rhs) { concat(rhs); return *this; }
+    String& operator +=(const char* cstr) { concat(cstr); return *this; }
+
+    bool equals(const char* cstr) const;
+    bool operator ==(const String& rhs) const { return _len == rhs._len && equals(rhs.c_str()); }
+    bool operator ==(const char* cstr) const { return equals(cstr); }
+    bool operator !=(const String& rhs) const { return !(*this == rhs); }
+    bool operator !=(const char* cstr) const { return !equals(cstr); }
+
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+    int toInt() const;
+
+protected:
+    // Arduino-ESP32 keeps strings up to SSO_SIZE - 1 characters inline
+    static const unsigned int SSO_SIZE = 11;
+
+    char* _heap;
+    unsigned int _cap;
+    unsigned int _len;
+    char _sso[SSO_SIZE];
+
+    char* buffer() { return _heap ? _heap : _sso; }
+    const char* buffer() const { return _heap ? _heap : _sso; }
+    void init();
+    void invalidate();
+    bool changeBuffer(unsigned int maxStrLen);
+    String& copy(const char* cstr, unsigned int length);
+    void move(String& rhs);
+};
+
+class StringSumHelper : public String {
+public:
+    StringSumHelper(const String& s) : String(s) {}
+    StringSumHelper(const char* p) : String(p) {}
+    StringSumHelper(char c) : String(c) {}
+    StringSumHelper(int num) : String(num) {}
+    StringSumHelper(unsigned int num) : String(num) {}
+    StringSumHelper(long num) : String(num) {}
+    StringSumHelper(unsigned long num) : String(num) {}
+};
+
+StringSumHelper& operator +(const StringSumHelper& lhs, const String& rhs);
+StringSumHelper& operator +(const StringSumHelper& lhs, const char* cstr);
+StringSumHelper& operator +(const StringSumHelper& lhs, char c);
+StringSumHelper& operator +(const StringSumHelper& lhs, int num);
+StringSumHelper& operator +(const StringSumHelper& lhs, unsigned int num);
+StringSumHelper& operator +(const StringSumHelper& lhs, long num);
+StringSumHelper& operator +(const StringSumHelper& lhs, unsigned long num);
+StringSumHelper& operator +(const StringSumHelper& lhs, const __FlashStringHelper* rhs);
@@ -0,0 +1,291 @@
+#include "WebServer.h"
+#include "SimHeap.h"
+#include "Update.h"
+#include <deque>
+#include <new>
+
+UpdateClass Update;
+
+namespace sim {
+
+namespace {
+
+// Synthetic lwIP costs: a PCB per connection that lingers in TIME_WAIT
+// for a few more requests, an RX pbuf for the request, and TX segments that
+// writes are appended to (one pbuf per MSS) and that stay allocated until
+// acknowledged, bounded by the send buffer.
+const size_t PCB_SIZE = 196;
+const size_t PBUF_OVERHEAD = 56;
+const size_t RX_PBUF_SIZE = 1600;
+const size_t TCP_MSS = 1436;
+const size_t TCP_SND_BUF = 5744;
+const size_t TIME_WAIT_CONNECTIONS = 3;
+
+WebServer* active = nullptr;
+bool pending = false;
+HttpRequest request;
+HttpResponse response;
+
+std::deque<void*> timeWait;
+std::deque<void*> txQueue;
+size_t txTailSpace = 0;
+
+void ackAll() {
+    for (void* seg : txQueue) heapFree(seg);
+    txQueue.clear();
+    txTailSpace = 0;
+}
+
+void transmit(size_t len) {
+    while (len > 0) {
+        if (txTailSpace == 0) {
+            // The socket blocks until the peer acknowledges the oldest segment
+            if (txQueue.size() * TCP_MSS >= TCP_SND_BUF) {
+                heapFree(txQueue.front());
+                txQueue.pop_front();
+            }
+            txQueue.push_back(heapMalloc(TCP_MSS + PBUF_OVERHEAD));
+            txTailSpace = TCP_MSS;
+        }
+        size_t n = len < txTailSpace ? len : txTailSpace;
+        txTailSpace -= n;
+        len -= n;
+    }
+}
+
+}
+
+void httpSubmit(const HttpRequest& r) {
+    request = r;
+    pending = true;
+}
+
+bool httpPending() { return pending; }
+const HttpResponse& httpLastResponse() { return response; }
+
+void httpReset() {
+    ackAll();
+    for (void* pcb : timeWait) heapFree(pcb);
+    timeWait.clear();
+    pending = false;
+}
+
+}
+
+using namespace sim;
+
+WebServer::WebServer(int)
+    : _args(nullptr), _argCount(0), _contentLength(CONTENT_LENGTH_NOT_SET), _chunked(false) {
+    active = this;
+}
+
+WebServer::~WebServer() {
+    if (active == this) active = nullptr;
+}
+
+void WebServer::begin() {}
+
+void WebServer::on(const char* uri, THandlerFunction fn) { on(uri, HTTP_ANY, fn); }
+void WebServer::on(const char* uri, HTTPMethod method, THandlerFunction fn) { _routes.push_back({uri, method, fn}); }
+void WebServer::on(const char* uri, HTTPMethod method, THandlerFunction fn, THandlerFunction) { on(uri, method, fn); }
+void WebServer::onNotFound(THandlerFunction fn) { _notFound = fn; }
+
+void WebServer::handleClient() {
+    if (!pending || active != this) return;
+    pending = false;
+    response = HttpResponse();
+    
+    // Accept: new PCB, request lands in an RX pbuf
+    void* pcb = heapMalloc(PCB_SIZE);
+    void* rx = heapMalloc(RX_PBUF_SIZE);
+    
+    // Parse: URI, host header and arguments as Strings, argument array on the heap
+    String uri(request.uri.c_str());
+    _hostHeader = request.host.empty() ? "192.168.1.1" : request.host.c_str();
+    
+    // As in the real server's _parseRequest(): a urlencoded body is parsed into
+    // arguments, a multipart body goes to the form parser (not modelled), and
+    // only any other content type (or none) is exposed as the "plain" argument
+    std::vector<std::pair<std::string, std::string>> args = request.args;
+    bool encoded = request.contentType.rfind("application/x-www-form-urlencoded", 0) == 0;
+    bool multipart = request.contentType.rfind("multipart/", 0) == 0;
+    bool plain = !request.body.empty() && !encoded && !multipart;
+    if (encoded) {
+        size_t start = 0;
+        while (start < request.body.size()) {
+            size_t end = request.body.find('&', start);
+            if (end == std::string::npos) end = request.body.size();
+            std::string pair = request.body.substr(start, end - start);
+            size_t eq = pair.find('=');
+            if (!pair.empty()) {
+                args.push_back({pair.substr(0, eq), eq == std::string::npos ? "" : pair.substr(eq + 1)});
+            }
+            start = end + 1;
+        }
+    }
+    
+    _argCount = args.size() + (plain ? 1 : 0);
+    _args = nullptr;
+    void* plainBuf = nullptr;
+    // The real server mallocs plainBuf for any non-multipart body
+    if (!request.body.empty() && !multipart) plainBuf = heapMalloc(request.body.size() + 1);
+    if (_argCount > 0) {
+        _args = static_cast<RequestArgument*>(heapMalloc(_argCount * sizeof(RequestArgument)));
+        int i = 0;
+        for (auto& a : args) {
+            new (&_args[i]) RequestArgument{String(a.first.c_str()), String(a.second.c_str())};
+            i++;
+        }
+        if (plain) {
+            // ...then copies it into the "plain" argument
+            new (&_args[i]) RequestArgument{String("plain"), String(request.body.c_str())};
+        }
+    }
+    if (plainBuf) heapFree(plainBuf);
+    heapFree(rx);
+    
+    THandlerFunction handler = _notFound;
+    for (auto& route : _routes) {
+        if (route.uri == uri.c_str() && (route.method == HTTP_ANY || route.method == request.method)) {
+            handler = route.fn;
+            break;
+        }
+    }
+    
+    struct Cleanup {
+        WebServer* server;
+        void* pcb;
+        ~Cleanup() {
+            for (int i = 0; i < server->_argCount; i++) server->_args[i].~RequestArgument();
+            heapFree(server->_args);
+            server->_args = nullptr;
+            server->_argCount = 0;
+            server->_hostHeader = String();
+            server->_responseHeaders = String();
+            server->_contentLength = CONTENT_LENGTH_NOT_SET;
+            server->_chunked = false;
+            ackAll();
+            timeWait.push_back(pcb);
+            if (timeWait.size() > TIME_WAIT_CONNECTIONS) {
+                heapFree(timeWait.front());
+                timeWait.pop_front();
+            }
+        }
+    } cleanup{this, pcb};
+    
+    if (handler) handler();
+    else send(404, "text/plain", "");
+}
+
+String WebServer::arg(const String& name) {
+    for (int i = 0; i < _argCount; i++) {
+        if (_args[i].key == name) return _args[i].value;
+    }
+    return String();
+}
+
+bool WebServer::hasArg(const String& name) {
+    for (int i = 0; i < _argCount; i++) {
+        if (_args[i].key == name) return true;
+    }
+    return false;
+}
+
+String WebServer::hostHeader() { return _hostHeader; }
+
+void WebServer::send(int code, const char* content_type, const String& content) {
+    if (_contentLength == CONTENT_LENGTH_NOT_SET) _contentLength = content.length();
+    
+    // Mirrors WebServer::_prepareHeader()
+    String header;
+    header += "HTTP/1.1 ";
+    header += code;
+    header += code == 200 ? " OK" : code == 302 ? " Found" : code == 404 ? " Not Found" : " Error";
+    header += "\r\n";
+    header += "Content-Type: ";
+    header += content_type ? content_type : "text/html";
+    header += "\r\n";
+    if (_contentLength == CONTENT_LENGTH_UNKNOWN) {
+        _chunked = true;
+        header += "Accept-Ranges: none\r\nTransfer-Encoding: chunked\r\n";
+    } else {
+        header += "Content-Length: ";
+        header += (unsigned long)_contentLength;
+        header += "\r\n";
+    }
+    header += _responseHeaders;
+    header += "Connection: close\r\n\r\n";
+    _responseHeaders = String();
+    
+    response.code = code;
+    response.contentType = content_type ? content_type : "text/html";
+    write(header.c_str(), header.length(), false);
+    if (content.length()) write(content.c_str(), content.length(), true);
+    _contentLength = CONTENT_LENGTH_NOT_SET;
+}
+
+void WebServer::send(int code, const char* content_type, const char* content) {
+    size_t len = content ? strlen(content) : 0;
+    if (_contentLength == CONTENT_LENGTH_NOT_SET) _contentLength = len;
+    send(code, content_type, String());
+    if (len) write(content, len, true);
+}
+
+void WebServer::send(int code, const String& content_type, const String& content) {
+    send(code, content_type.c_str(), content);
+}
+
+void WebServer::setContentLength(const size_t contentLength) {
+    _contentLength = contentLength;
+}
+
+void WebServer::sendHeader(const String& name, const String& value, bool first) {
+    String line;
+    line += name;
+    line += ": ";
+    line += value;
+    line += "\r\n";
+    if (first) {
+        line += _responseHeaders;
+        _responseHeaders = static_cast<String&&>(line);
+    } else {
+        _responseHeaders += line;
+    }
+}
+
+void WebServer::sendContent(const String& content) {
+    sendContent(content.c_str(), content.length());
+}
+
+void WebServer::sendContent(const char* content, size_t contentLength) {
+    if (_chunked) {
+        // Arduino-ESP32 mallocs the chunk-size line for every chunk
+        char* chunkSize = static_cast<char*>(heapMalloc(11));
+        if (chunkSize) {
+            snprintf(chunkSize, 11, "%x\r\n", (unsigned)contentLength);
+            write(chunkSize, strlen(chunkSize), false);
+            heapFree(chunkSize);
+        }
+    }
+    write(content, contentLength, true);
+    if (_chunked) {
+        write("\r\n", 2, false);
+        if (contentLength == 0) _chunked = false;
+    }
+}
+
+void WebServer::sendContent_P(PGM_P content) {
+    sendContent(content, strlen(content));
+}
+
+void WebServer::sendContent_P(PGM_P content, size_t size) {
+    sendContent(content, size);
+}
+
+void WebServer::write(const char* data, size_t len, bool body) {
+    if (len == 0) return;
+    transmit(len);
+    response.wireBytes += len;
+    response.writes++;
+    if (body) response.body.append(data, len);
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include "Arduino.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS };
+enum HTTPUploadStatus { UPLOAD_FILE_START, UPLOAD_FILE_WRITE, UPLOAD_FILE_END, UPLOAD_FILE_ABORTED };
+
+#define HTTP_UPLOAD_BUFLEN 1436
+#define CONTENT_LENGTH_UNKNOWN ((size_t) -1)
+#define CONTENT_LENGTH_NOT_SET ((size_t) -2)
+
+typedef struct {
+    HTTPUploadStatus status;
+    String filename;
+    String name;
+    String type;
+    size_t totalSize;
+    size_t currentSize;
+    uint8_t buf[HTTP_UPLOAD_BUFLEN];
+} HTTPUpload;
+
+// Request/response surface of Arduino-ESP32's WebServer. Requests are
+// injected by the harness and dispatched from handleClient(); the per-request
+// heap work of the real server (URI, argument and header Strings, response
+// header, per-chunk size buffer) is reproduced on the simulated heap.
+class WebServer {
+public:
+    typedef std::function<void(void)> THandlerFunction;
+
+    WebServer(int port = 80);
+    ~WebServer();
+
+    void begin();
+    void handleClient();
+
+    void on(const char* uri, THandlerFunction fn);
+    void on(const char* uri, HTTPMethod method, THandlerFunction fn);
+    void on(const char* uri, HTTPMethod method, THandlerFunction fn, THandlerFunction ufn);
+    void onNotFound(THandlerFunction fn);
+
+    String arg(const String& name);
+    bool hasArg(const String& name);
+    String hostHeader();
+    HTTPUpload& upload() { return _upload; }
+
+    void send(int code, const char* content_type = nullptr, const String& content = String(""));
+    void send(int code, const char* content_type, const char* content);
+    void send(int code, const String& content_type, const String& content);
+    void setContentLength(const size_t contentLength);
+    void sendHeader(const String& name, const String& value, bool first = false);
+    void sendContent(const String& content);
+    void sendContent(const char* content, size_t contentLength);
+    void sendContent_P(PGM_P content);
+    void sendContent_P(PGM_P content, size_t size);
+
+private:
+    struct Route {
+        std::string uri;
+        HTTPMethod method;
+        THandlerFunction fn;
+    };
+    struct RequestArgument {
+        String key;
+        String value;
+    };
+
+    std::vector<Route> _routes;
+    THandlerFunction _notFound;
+    HTTPUpload _upload;
+
+    RequestArgument* _args;
+    int _argCount;
+    String _hostHeader;
+    String _responseHeaders;
+    size_t _contentLength;
+    bool _chunked;
+
+    void write(const char* data, size_t len, bool body);
+};
+
+namespace sim {
+
+struct HttpRequest {
+    HTTPMethod method;
+    std::string uri;
+    std::vector<std::pair<std::string, std::string>> args;  // query/form arguments
+    std::string body;                                       // raw body, exposed as arg "plain"
+    std::string contentType;                                // Content-Type header, empty for none
+    std::string host;
+};
+
+struct HttpResponse {
+    int code;
+    std::string contentType;
+    std::string body;       // de-chunked payload
+    size_t wireBytes;       // everything written to the socket
+    uint32_t writes;        // socket write calls
+};
+
+// Queues a request for the next WebServer::handleClient()
+void httpSubmit(const HttpRequest& request);
+bool httpPending();
+const HttpResponse& httpLastResponse();
+// Frees connection state still held by the synthetic TCP stack
+void httpReset();
+
+}
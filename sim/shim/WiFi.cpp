@@ -0,0 +1,164 @@
+#include "WiFi.h"
+#include "SimBoard.h"
+#include "SimHeap.h"
+
+WiFiClass WiFi;
+
+namespace sim {
+
+namespace {
+
+// Association takes this long once the AP is reachable
+const uint32_t CONNECT_TIME_MS = 3000;
+// A blocking all-channel scan
+const uint32_t SCAN_TIME_MS = 2200;
+// Supplicant/association buffers held while (re)connecting
+const size_t ASSOC_BUFFER_SIZE = 1664;
+
+wifi_mode_t mode = WIFI_MODE_NULL;
+wl_status_t status = WL_IDLE_STATUS;
+bool linkUp = true;
+bool connecting = false;
+uint32_t connectStart = 0;
+void* assocBuffer = nullptr;
+
+wifi_ap_record_t* scanList = nullptr;
+int scanCount = 0;
+int scanSize = 8;
+
+std::function<void(WiFiSimEvent)> eventHook;
+
+void notify(WiFiSimEvent event) {
+    if (eventHook) eventHook(event);
+}
+
+void startConnect() {
+    if (!assocBuffer) assocBuffer = heapMalloc(ASSOC_BUFFER_SIZE);
+    connecting = true;
+    connectStart = now();
+    status = WL_DISCONNECTED;
+}
+
+void dropLink() {
+    heapFree(assocBuffer);
+    assocBuffer = nullptr;
+    connecting = false;
+}
+
+}
+
+void wifiSetLinkUp(bool up) {
+    linkUp = up;
+    if (!up && status == WL_CONNECTED) {
+        status = WL_CONNECTION_LOST;
+        dropLink();
+    }
+}
+
+void wifiSetScanSize(int n) { scanSize = n; }
+void wifiSetEventHook(std::function<void(WiFiSimEvent)> hook) { eventHook = hook; }
+
+void wifiReset() {
+    dropLink();
+    WiFi.scanDelete();
+    mode = WIFI_MODE_NULL;
+    status = WL_IDLE_STATUS;
+}
+
+}
+
+using namespace sim;
+
+bool WiFiClass::mode(wifi_mode_t m) {
+    sim::mode = m;
+    if (m == WIFI_MODE_STA) notify(SIM_WIFI_MODE_STA);
+    if (m == WIFI_MODE_AP) notify(SIM_WIFI_MODE_AP);
+    if (m != WIFI_MODE_STA) {
+        dropLink();
+        sim::status = WL_IDLE_STATUS;
+    }
+    return true;
+}
+
+wifi_mode_t WiFiClass::getMode() { return sim::mode; }
+
+wl_status_t WiFiClass::begin(const char*, const char*) {
+    startConnect();
+    return sim::status;
+}
+
+bool WiFiClass::config(IPAddress, IPAddress, IPAddress, IPAddress, IPAddress) { return true; }
+bool WiFiClass::setHostname(const char*) { return true; }
+
+bool WiFiClass::reconnect() {
+    notify(SIM_WIFI_RECONNECT);
+    startConnect();
+    return true;
+}
+
+bool WiFiClass::disconnect(bool, bool) {
+    dropLink();
+    if (sim::status == WL_CONNECTED) sim::status = WL_DISCONNECTED;
+    return true;
+}
+
+wl_status_t WiFiClass::status() {
+    if (connecting && sim::mode == WIFI_MODE_STA && linkUp && now() - connectStart >= CONNECT_TIME_MS) {
+        dropLink();
+        sim::status = WL_CONNECTED;
+    }
+    return sim::status;
+}
+
+IPAddress WiFiClass::localIP() {
+    return sim::status == WL_CONNECTED ? IPAddress(10, 0, 0, 42) : IPAddress();
+}
+
+int8_t WiFiClass::RSSI() {
+    return sim::status == WL_CONNECTED ? -61 : 0;
+}
+
+bool WiFiClass::softAPConfig(IPAddress, IPAddress, IPAddress) { return true; }
+bool WiFiClass::softAP(const char*, const char*, int, int, int) { return true; }
+IPAddress WiFiClass::softAPIP() { return IPAddress(192, 168, 1, 1); }
+
+int16_t WiFiClass::scanNetworks(bool, bool) {
+    // Arduino-ESP32 drops the previous result list before scanning
+    scanDelete();
+    notify(SIM_WIFI_SCAN);
+    delay(SCAN_TIME_MS);
+    if (scanSize <= 0) return 0;
+    
+    scanList = static_cast<wifi_ap_record_t*>(heapMalloc(scanSize * sizeof(wifi_ap_record_t)));
+    if (!scanList) return -2;
+    scanCount = scanSize;
+    for (int i = 0; i < scanCount; i++) {
+        wifi_ap_record_t& ap = scanList[i];
+        memset(&ap, 0, sizeof(ap));
+        // SSIDs of varying length, up to the 32-byte maximum
+        int len = 4 + (i * 7) % 29;
+        for (int c = 0; c < len; c++) ap.ssid[c] = 'A' + (i + c) % 26;
+        ap.rssi = -40 - (i * 5) % 55;
+        ap.primary = 1 + i % 13;
+    }
+    return scanCount;
+}
+
+void WiFiClass::scanDelete() {
+    heapFree(scanList);
+    scanList = nullptr;
+    scanCount = 0;
+}
+
+String WiFiClass::SSID(uint8_t i) {
+    if (i >= scanCount) return String();
+    return String(reinterpret_cast<const char*>(scanList[i].ssid));
+}
+
+int32_t WiFiClass::RSSI(uint8_t i) {
+    return i < scanCount ? scanList[i].rssi : 0;
+}
+
+void* WiFiClass::getScanInfoByIndex(int i) {
+    return (i >= 0 && i < scanCount) ? &scanList[i] : nullptr;
+}
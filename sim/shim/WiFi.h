@@ -0,0 +1,85 @@
+#pragma once
+#include "Arduino.h"
+
+typedef enum {
+    WL_NO_SHIELD = 255,
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+    WIFI_MODE_NULL = 0,
+    WIFI_MODE_STA,
+    WIFI_MODE_AP,
+    WIFI_MODE_APSTA
+} wifi_mode_t;
+
+#define WIFI_OFF WIFI_MODE_NULL
+#define WIFI_STA WIFI_MODE_STA
+#define WIFI_AP  WIFI_MODE_AP
+
+// Same layout-relevant fields as ESP-IDF's record (80 bytes there)
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t ssid[33];
+    uint8_t primary;
+    int second;
+    int8_t rssi;
+    int authmode;
+    uint8_t reserved[28];
+} wifi_ap_record_t;
+
+class WiFiClass {
+public:
+    bool mode(wifi_mode_t m);
+    wifi_mode_t getMode();
+
+    wl_status_t begin(const char* ssid, const char* passphrase = nullptr);
+    bool config(IPAddress local_ip, IPAddress gateway, IPAddress subnet,
+                IPAddress dns1 = IPAddress(), IPAddress dns2 = IPAddress());
+    bool setHostname(const char* hostname);
+    bool reconnect();
+    bool disconnect(bool wifioff = false, bool eraseap = false);
+    wl_status_t status();
+    IPAddress localIP();
+    int8_t RSSI();
+
+    bool softAPConfig(IPAddress local_ip, IPAddress gateway, IPAddress subnet);
+    bool softAP(const char* ssid, const char* passphrase = nullptr, int channel = 1,
+                int ssid_hidden = 0, int max_connection = 4);
+    IPAddress softAPIP();
+
+    int16_t scanNetworks(bool async = false, bool show_hidden = false);
+    void scanDelete();
+    String SSID(uint8_t networkItem);
+    int32_t RSSI(uint8_t networkItem);
+    void* getScanInfoByIndex(int i);
+};
+
+extern WiFiClass WiFi;
+
+// Simulated radio environment
+namespace sim {
+
+enum WiFiSimEvent {
+    SIM_WIFI_RECONNECT,
+    SIM_WIFI_MODE_STA,
+    SIM_WIFI_MODE_AP,
+    SIM_WIFI_SCAN
+};
+
+// Whether the configured access point is reachable
+void wifiSetLinkUp(bool up);
+// Number of networks the next scan reports
+void wifiSetScanSize(int n);
+// Observes firmware-initiated radio operations
+void wifiSetEventHook(std::function<void(WiFiSimEvent event)> hook);
+// Drops all radio state and frees its heap, as on reboot
+void wifiReset();
+
+}
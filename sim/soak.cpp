@@ -0,0 +1,597 @@
+// Accelerated-time soak of the firmware: replays months of synthetic traffic
+// against the real sources and checks heap health and millis() timers across
+// the 49.7-day rollover. Exit status is non-zero on any violation.
+#include "SimDevice.h"
+#include "SimBoard.h"
+#include "SimHeap.h"
+#include "definitions.h"
+#include <WebServer.h>
+#include <WiFi.h>
+#include <cinttypes>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+const uint64_t SECOND = 1000;
+const uint64_t MINUTE = 60 * SECOND;
+const uint64_t HOUR = 60 * MINUTE;
+const uint64_t DAY = 24 * HOUR;
+const uint64_t ROLLOVER = 1ULL << 32;
+
+// Loop granularity: coarse while nothing time-critical is going on
+const uint32_t FINE_STEP = 10;
+const uint32_t COARSE_STEP = 1000;
+
+// Firmware timing contracts under test
+const uint32_t BUTTON_HOLD_MS = 5000;
+const uint32_t RECONNECT_INTERVAL_MS = 10000;
+const uint32_t CONNECT_TIME_MS = 3000;
+const uint32_t AP_BLINK_MS = 1000;
+
+const int MAX_BACKGROUND_BLOCKS = 64;
+
+typedef std::vector<std::pair<std::string, std::string>> Args;
+
+struct Rng {
+    uint64_t state;
+    uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+    uint64_t range(uint64_t lo, uint64_t hi) { return lo + next() % (hi - lo + 1); }
+    // Exponentially distributed interval around mean, clamped to [mean/20, 4*mean]
+    uint64_t interval(uint64_t mean) {
+        double u = (next() % 1000000 + 1) / 1000001.0;
+        double v = -log(u) * mean;
+        if (v < mean / 20.0) v = mean / 20.0;
+        if (v > mean * 4.0) v = mean * 4.0;
+        return (uint64_t)v;
+    }
+};
+
+// One power-on period, ended by a maintenance session (long press, AP mode,
+// scans, save) that reboots the unit. maintenanceAt is the long-press time.
+struct BootPlan {
+    const char* name;
+    uint64_t maintenanceAt;
+    uint64_t tapAt;     // extra short tap at a fixed uptime, 0 for none
+    uint32_t tapMs;
+};
+
+struct RequestStats {
+    uint32_t count;
+    uint64_t allocs;
+    uint64_t bodyBytes;
+    size_t largestRequest;
+};
+
+struct BootReport {
+    std::string name;
+    uint64_t uptime;
+    uint32_t requests;
+    size_t largestFreeAfterHour;
+    size_t largestFreeAtEnd;
+    sim::HeapStats heap;
+    size_t leak;
+};
+
+struct BackgroundBlock {
+    void* ptr;
+    uint64_t freeAt;
+};
+
+class Soak {
+public:
+    explicit Soak(uint64_t seed) : _rng{seed ? seed : 1} {}
+    int run();
+
+private:
+    Rng _rng;
+    SimDevice _device;
+
+    // Uptime since the current boot, 64-bit so it does not wrap with millis()
+    uint64_t _uptime = 0;
+    uint32_t _lastClock = 0;
+    uint64_t _iterStart = 0;
+    uint32_t _step = COARSE_STEP;
+
+    // Button: held while _pressActive and uptime in [_pressStart, _pressEnd)
+    bool _pressActive = false;
+    uint64_t _pressStart = 0;
+    uint64_t _pressEnd = 0;
+    bool _expectAp = false;
+    bool _apEntered = false;
+    bool _apAtBoot = false;
+
+    bool _linkUp = true;
+    uint64_t _linkRestoredAt = 0;
+    bool _awaitingReconnect = false;
+
+    // Last timer events, and whether a blocking call happened since
+    uint64_t _lastToggle = 0;
+    bool _haveToggle = false;
+    bool _blockedSinceToggle = false;
+    uint64_t _lastReconnect = 0;
+    bool _haveReconnect = false;
+    bool _blockedSinceReconnect = false;
+
+    std::map<std::string, uint64_t> _checks;
+    std::vector<std::string> _violations;
+    uint64_t _violationCount = 0;
+
+    std::map<std::string, RequestStats> _requests;
+    std::vector<BootReport> _boots;
+    std::vector<BackgroundBlock> _background;
+
+    uint64_t now() const { return _uptime + (uint32_t)(sim::now() - _lastClock); }
+    void syncClock();
+    bool nearRollover() const;
+    bool rebooted(uint32_t boots) const { return _device.boots() != boots; }
+
+    void check(const char* name, bool ok, const char* fmt, ...) __attribute__((format(printf, 4, 5)));
+    void onPinChange(uint8_t pin);
+    void onWiFiEvent(sim::WiFiSimEvent event);
+
+    bool iterate();
+    // Runs the loop until target uptime; false if the device rebooted
+    bool runUntil(uint64_t target);
+    bool request(const char* label, HTTPMethod method, const char* uri, const Args& args = Args());
+    void press(uint32_t durationMs);
+    void backgroundChurn();
+    void releaseBackground(bool all);
+
+    void beginBoot(const char* name);
+    void endBoot();
+    void provision();
+    void runBoot(const BootPlan& plan);
+    void maintenance();
+    void sosProbe(uint32_t startClock);
+    void report();
+};
+
+void Soak::check(const char* name, bool ok, const char* fmt, ...) {
+    _checks[name]++;
+    if (ok) return;
+    _violationCount++;
+    if (_violations.size() >= 20) return;
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    char line[384];
+    snprintf(line, sizeof(line), "boot %u @ %.4f d (millis %" PRIu32 "): %s: %s",
+             _device.boots(), now() / (double)DAY, sim::now(), name, buf);
+    _violations.push_back(line);
+}
+
+void Soak::syncClock() {
+    _uptime = now();
+    _lastClock = sim::now();
+}
+
+bool Soak::nearRollover() const {
+    uint64_t phase = _uptime % ROLLOVER;
+    return phase < MINUTE || ROLLOVER - phase < MINUTE;
+}
+
+void Soak::onPinChange(uint8_t pin) {
+    if (pin != PIN_LED_STATUS || !_device.net().isAPMode()) return;
+    uint64_t t = now();
+    // Time spent inside this pass (scan, button release wait) delays the toggle
+    if (t > _iterStart) _blockedSinceToggle = true;
+    if (_haveToggle) {
+        uint64_t gap = t - _lastToggle;
+        check("ap_blink_min", gap >= AP_BLINK_MS, "status LED toggled after %" PRIu64 " ms", gap);
+        if (!_blockedSinceToggle) {
+            check("ap_blink_max", gap <= AP_BLINK_MS + _step, "status LED toggled after %" PRIu64 " ms", gap);
+        }
+    }
+    _lastToggle = t;
+    _haveToggle = true;
+    _blockedSinceToggle = false;
+}
+
+void Soak::onWiFiEvent(sim::WiFiSimEvent event) {
+    uint64_t t = now();
+    if (event == sim::SIM_WIFI_RECONNECT) {
+        if (t > _iterStart) _blockedSinceReconnect = true;
+        if (_haveReconnect) {
+            uint64_t gap = t - _lastReconnect;
+            check("reconnect_min", gap > RECONNECT_INTERVAL_MS, "reconnect after %" PRIu64 " ms", gap);
+            if (!_blockedSinceReconnect) {
+                check("reconnect_max", gap <= RECONNECT_INTERVAL_MS + _step, "reconnect after %" PRIu64 " ms", gap);
+            }
+        }
+        _lastReconnect = t;
+        _haveReconnect = true;
+        _blockedSinceReconnect = false;
+    } else if (event == sim::SIM_WIFI_MODE_AP) {
+        _haveToggle = false;
+        if (_apAtBoot) return;
+        if (!_expectAp) {
+            check("button_hold", false, "AP mode entered without a long press");
+            return;
+        }
+        uint64_t held = t - _pressStart;
+        check("button_hold", held > BUTTON_HOLD_MS && held <= BUTTON_HOLD_MS + 2 * FINE_STEP,
+              "AP mode entered %" PRIu64 " ms after press", held);
+        _expectAp = false;
+        _apEntered = true;
+    }
+}
+
+bool Soak::iterate() {
+    _iterStart = _uptime;
+    if (!_device.loop()) return false;
+
+    uint64_t before = _uptime;
+    syncClock();
+    if (_uptime != before) {
+        _blockedSinceToggle = true;
+        _blockedSinceReconnect = true;
+    }
+
+    if (_pressActive && _uptime >= _pressEnd) {
+        _pressActive = false;
+        check("button_hold", !_expectAp, "long press did not enter AP mode");
+        _expectAp = false;
+    }
+
+    // Reconnect liveness once the AP is reachable again
+    if (_awaitingReconnect && WiFi.status() == WL_CONNECTED) {
+        _awaitingReconnect = false;
+        _haveReconnect = false;
+        uint64_t took = _uptime - _linkRestoredAt;
+        check("reconnect_live", took <= RECONNECT_INTERVAL_MS + CONNECT_TIME_MS + 2 * COARSE_STEP,
+              "reconnected %" PRIu64 " ms after the link came back", took);
+    }
+    return true;
+}
+
+bool Soak::runUntil(uint64_t target) {
+    // Always one pass, so state due at the current uptime is processed
+    do {
+        bool fine = _pressActive || _device.net().isAPMode() || !_linkUp || _awaitingReconnect
+                    || nearRollover() || _uptime < MINUTE;
+        _step = fine ? FINE_STEP : COARSE_STEP;
+        if (!iterate()) return false;
+        if (_uptime >= target) break;
+        uint64_t step = _step;
+        if (_uptime + step > target) step = target - _uptime;
+        sim::advance((uint32_t)step);
+        syncClock();
+    } while (_uptime < target);
+    return true;
+}
+
+bool Soak::request(const char* label, HTTPMethod method, const char* uri, const Args& args) {
+    sim::HttpRequest r;
+    r.method = method;
+    r.uri = uri;
+    r.args = args;
+    r.host = _device.net().isAPMode() ? "192.168.1.1" : "10.0.0.42";
+    sim::httpSubmit(r);
+
+    sim::heapWindowBegin();
+    _step = FINE_STEP;
+    bool alive = iterate();
+    _boots.back().requests++;
+
+    RequestStats& s = _requests[label];
+    s.count++;
+    if (!alive) return false;
+    const sim::HeapStats& h = sim::heapWindow();
+    s.allocs += h.allocs + h.reallocs;
+    s.bodyBytes += sim::httpLastResponse().body.size();
+    if (h.largestRequest > s.largestRequest) s.largestRequest = h.largestRequest;
+    check("http_status", sim::httpLastResponse().code < 500, "%s returned %d", label, sim::httpLastResponse().code);
+    return true;
+}
+
+void Soak::press(uint32_t durationMs) {
+    _pressActive = true;
+    _pressStart = _uptime;
+    _pressEnd = _uptime + durationMs;
+    _expectAp = durationMs > BUTTON_HOLD_MS + 2 * FINE_STEP;
+    _apEntered = false;
+}
+
+void Soak::backgroundChurn() {
+    // Long-lived allocations from the rest of the system (timers, DHCP, ARP...)
+    releaseBackground(false);
+    if ((int)_background.size() >= MAX_BACKGROUND_BLOCKS) return;
+    void* p = sim::heapMalloc(_rng.range(32, 1024));
+    if (p) _background.push_back({p, _uptime + _rng.range(MINUTE, 3 * DAY)});
+}
+
+void Soak::releaseBackground(bool all) {
+    for (size_t i = 0; i < _background.size();) {
+        if (all || _background[i].freeAt <= _uptime) {
+            sim::heapFree(_background[i].ptr);
+            _background[i] = _background.back();
+            _background.pop_back();
+        } else {
+            i++;
+        }
+    }
+}
+
+void Soak::beginBoot(const char* name) {
+    BootReport r = BootReport();
+    r.name = name;
+    _boots.push_back(r);
+    _uptime = 0;
+    _lastClock = sim::now();
+    _haveToggle = false;
+    _haveReconnect = false;
+    _awaitingReconnect = false;
+    _linkUp = true;
+    sim::wifiSetLinkUp(true);
+}
+
+void Soak::endBoot() {
+    BootReport& b = _boots.back();
+    b.uptime = _uptime;
+    b.heap = _device.lastBootHeap();
+    b.leak = _device.lastLeak();
+    check("heap_leak", b.leak == 0, "%zu bytes still allocated at reboot", b.leak);
+    check("heap_failures", b.heap.failures == 0, "%" PRIu64 " failed allocations", b.heap.failures);
+}
+
+void Soak::provision() {
+    // Factory state: no SSID, so the firmware comes up in AP mode
+    sim::nvsErase();
+    _apAtBoot = true;
+    _device.boot();
+    _apAtBoot = false;
+    beginBoot("provisioning");
+
+    uint32_t boots = _device.boots();
+    runUntil(2 * MINUTE);
+    request("GET / (AP, scan)", HTTP_GET, "/");
+    runUntil(_uptime + MINUTE);
+    request("POST /save", HTTP_POST, "/save",
+            {{"ssid", "HomeNetwork"}, {"pass", "correct horse battery"}, {"dhcp", "on"}});
+    check("save_reboot", rebooted(boots), "save did not reboot");
+}
+
+void Soak::maintenance() {
+    // Hold the button into AP mode, browse with scans, save
+    uint32_t boots = _device.boots();
+    _boots.back().largestFreeAtEnd = sim::heapLargestFreeBlock();
+    press(6000);
+    runUntil(_uptime + 8 * SECOND);
+    check("button_hold", _apEntered, "maintenance long press did not enter AP mode");
+    for (int i = 0; i < 4 && !rebooted(boots); i++) {
+        sim::wifiSetScanSize((int)_rng.range(0, 20));
+        runUntil(_uptime + _rng.range(90 * SECOND, 3 * MINUTE));
+        request("GET / (AP, scan)", HTTP_GET, "/");
+    }
+    runUntil(_uptime + MINUTE);
+    releaseBackground(true);
+    request("POST /save", HTTP_POST, "/save",
+            {{"ssid", "HomeNetwork"}, {"pass", "correct horse battery"}, {"dhcp", "on"}});
+    check("save_reboot", rebooted(boots), "save did not reboot");
+}
+
+void Soak::runBoot(const BootPlan& plan) {
+    endBoot();
+    beginBoot(plan.name);
+
+    uint64_t nextPage = _rng.interval(4 * HOUR);
+    uint64_t nextStatus = 15 * MINUTE;
+    uint64_t nextConfig = _rng.interval(6 * HOUR);
+    uint64_t nextDrop = _rng.interval(2 * DAY);
+    uint64_t nextTap = _rng.interval(5 * DAY);
+    uint64_t nextChurn = _rng.interval(10 * MINUTE);
+    uint64_t linkBackAt = 0;
+    bool afterHourSampled = false;
+    bool tapDone = plan.tapAt == 0;
+    // Keep random traffic clear of the maintenance session and the fixed tap
+    uint64_t quietFrom = plan.maintenanceAt - 30 * MINUTE;
+
+    uint32_t boots = _device.boots();
+    while (_uptime < plan.maintenanceAt && !rebooted(boots)) {
+        uint64_t next = plan.maintenanceAt;
+        if (!tapDone && plan.tapAt < next) next = plan.tapAt;
+        for (uint64_t t : {nextPage, nextStatus, nextConfig, nextDrop, nextTap, nextChurn}) {
+            if (t < next) next = t;
+        }
+        if (!_linkUp && linkBackAt < next) next = linkBackAt;
+        if (!afterHourSampled && HOUR < next) next = HOUR;
+        if (_pressActive && _pressEnd < next) next = _pressEnd;
+        if (!runUntil(next)) break;
+
+        bool quiet = _uptime >= quietFrom || nearRollover() || _pressActive
+                     || (!tapDone && plan.tapAt >= _uptime && plan.tapAt - _uptime < 10 * MINUTE);
+        if (!afterHourSampled && _uptime >= HOUR) {
+            _boots.back().largestFreeAfterHour = sim::heapLargestFreeBlock();
+            afterHourSampled = true;
+        }
+        if (!tapDone && _uptime >= plan.tapAt && !_pressActive) {
+            press(plan.tapMs);
+            tapDone = true;
+        }
+        if (!_linkUp && _uptime >= linkBackAt) {
+            _linkUp = true;
+            sim::wifiSetLinkUp(true);
+            _linkRestoredAt = _uptime;
+            _awaitingReconnect = true;
+        }
+        if (_uptime >= nextChurn) {
+            backgroundChurn();
+            nextChurn = _uptime + _rng.interval(10 * MINUTE);
+        }
+        if (_uptime >= nextStatus) {
+            nextStatus = _uptime + 15 * MINUTE;
+            if (!quiet) request("GET /api/status", HTTP_GET, "/api/status");
+        }
+        if (_uptime >= nextConfig) {
+            nextConfig = _uptime + _rng.interval(6 * HOUR);
+            if (!quiet) request("GET /api/config", HTTP_GET, "/api/config");
+        }
+        if (_uptime >= nextPage) {
+            nextPage = _uptime + _rng.interval(4 * HOUR);
+            if (!quiet) request("GET / (STA)", HTTP_GET, "/");
+        }
+        if (_uptime >= nextDrop) {
+            nextDrop = _uptime + _rng.interval(2 * DAY);
+            if (!quiet && _linkUp && !_awaitingReconnect) {
+                _linkUp = false;
+                sim::wifiSetLinkUp(false);
+                linkBackAt = _uptime + _rng.range(20 * SECOND, 20 * MINUTE);
+            }
+        }
+        if (_uptime >= nextTap) {
+            nextTap = _uptime + _rng.interval(5 * DAY);
+            if (!quiet) press(_rng.range(150, 4000));
+        }
+    }
+
+    if (rebooted(boots)) {
+        check("unexpected_reboot", false, "device rebooted before maintenance");
+        return;
+    }
+    if (!_linkUp) {
+        _linkUp = true;
+        sim::wifiSetLinkUp(true);
+    }
+    maintenance();
+}
+
+void Soak::sosProbe(uint32_t startClock) {
+    // SOS only runs in the first ~31 s after boot, so it can only meet the
+    // rollover with a pre-advanced clock
+    static const uint8_t UNITS[] = {1, 1, 1, 1, 1, 4, 3, 1, 3, 1, 3, 4, 1, 1, 1, 1, 1, 12};
+    const size_t STEPS = sizeof(UNITS);
+    const uint32_t SEQUENCE_MS = 3 * 41 * MORSE_UNIT;
+
+    std::vector<uint32_t> transitions;
+    sim::resetPins();
+    sim::setPinChangeHook([&](uint8_t pin, int) {
+        if (pin == PIN_LED_SOS) transitions.push_back(sim::now());
+    });
+    sim::setNow(startClock);
+    SOSBlinker blinker(PIN_LED_SOS);
+    blinker.begin();
+    uint32_t finished = 0;
+    bool done = false;
+    for (uint32_t t = 0; t < SEQUENCE_MS + 10000; t++) {
+        blinker.update();
+        if (!done && !blinker.isRunning()) {
+            finished = t;
+            done = true;
+        }
+        sim::advance(1);
+    }
+    sim::setPinChangeHook(nullptr);
+
+    check("sos_sequence", transitions.size() == STEPS * 3,
+          "start %08" PRIx32 ": %zu LED transitions", startClock, transitions.size());
+    for (size_t i = 1; i < transitions.size(); i++) {
+        uint32_t gap = transitions[i] - transitions[i - 1];
+        uint32_t expected = UNITS[(i - 1) % STEPS] * MORSE_UNIT;
+        check("sos_timing", gap == expected, "start %08" PRIx32 ": step %zu lasted %" PRIu32 " ms, expected %" PRIu32,
+              startClock, i, gap, expected);
+    }
+    check("sos_sequence", done && finished == SEQUENCE_MS,
+          "start %08" PRIx32 ": sequence ended after %" PRIu32 " ms", startClock, finished);
+}
+
+int Soak::run() {
+    for (uint32_t start : {0u, 0xFFFFFFFFu - 5000, 0xFFFFFFFFu - 3 * 41 * MORSE_UNIT, 0xFFFFFFFFu}) {
+        sosProbe(start);
+    }
+
+    sim::setPinChangeHook([this](uint8_t pin, int) { onPinChange(pin); });
+    sim::wifiSetEventHook([this](sim::WiFiSimEvent e) { onWiFiEvent(e); });
+    sim::setInputSource([this](uint8_t pin) {
+        if (pin != PIN_BTN_CONFIG) return HIGH;
+        uint64_t t = now();
+        return (_pressActive && t >= _pressStart && t < _pressEnd) ? LOW : HIGH;
+    });
+
+    const BootPlan plans[] = {
+        {"12 days", 12 * DAY, 0, 0},
+        // Short tap straddling the rollover must not trigger AP mode
+        {"63 days, tap over rollover", 63 * DAY, ROLLOVER - 1500, 3000},
+        // Long press straddling the rollover must trigger AP mode once, 5 s in
+        {"long press over rollover", ROLLOVER - 2500, 0, 0},
+        // AP mode status blink running through the rollover
+        {"AP mode over rollover", ROLLOVER - 4 * MINUTE, 0, 0},
+        {"40 days", 40 * DAY, 0, 0},
+    };
+
+    provision();
+    for (const BootPlan& plan : plans) runBoot(plan);
+    endBoot();
+
+    report();
+    return _violationCount == 0 ? 0 : 1;
+}
+
+void Soak::report() {
+    uint64_t total = 0;
+    for (const BootReport& b : _boots) total += b.uptime;
+    printf("Simulated %.1f days over %zu boots, heap arena %zu bytes\n\n", total / (double)DAY, _boots.size(),
+           sim::HEAP_ARENA_SIZE);
+
+    printf("%-27s %6s %5s %8s %6s %7s %7s %7s %7s %7s %4s\n", "boot", "days", "reqs", "allocs", "moves",
+           "peak", "maxreq", "lfb min", "lfb 1h", "lfb end", "leak");
+    for (const BootReport& b : _boots) {
+        printf("%-27s %6.2f %5u %8" PRIu64 " %6" PRIu64 " %7zu %7zu %7zu %7zu %7zu %4zu\n", b.name.c_str(),
+               b.uptime / (double)DAY, b.requests, b.heap.allocs + b.heap.reallocs, b.heap.moves, b.heap.peakUsed,
+               b.heap.largestRequest, b.heap.minLargestFree, b.largestFreeAfterHour, b.largestFreeAtEnd, b.leak);
+    }
+    printf("allocs = malloc + realloc, moves = reallocs that copied, peak = peak heap in use,\n"
+           "maxreq = largest single allocation, lfb = largest free block (lowest after any\n"
+           "allocation / at 1 h uptime / before maintenance)\n\n");
+
+    printf("%-20s %7s %10s %10s %8s\n", "request", "count", "allocs/req", "bytes/req", "maxreq");
+    for (const auto& r : _requests) {
+        const RequestStats& s = r.second;
+        if (r.first == "POST /save") {
+            printf("%-20s %7u %10s %10s %8s  (reboots)\n", r.first.c_str(), s.count, "-", "-", "-");
+            continue;
+        }
+        printf("%-20s %7u %10.1f %10.0f %8zu\n", r.first.c_str(), s.count, (double)s.allocs / s.count,
+               (double)s.bodyBytes / s.count, s.largestRequest);
+    }
+
+    printf("\nchecks:\n");
+    for (const auto& c : _checks) printf("  %-16s %9" PRIu64 "\n", c.first.c_str(), c.second);
+    if (_violationCount == 0) {
+        printf("\nPASS\n");
+    } else {
+        printf("\nFAIL: %" PRIu64 " violations\n", _violationCount);
+        for (const std::string& v : _violations) printf("  %s\n", v.c_str());
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    uint64_t seed = 0x5EED5EED;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 0);
+        } else if (strcmp(argv[i], "--serial") == 0) {
+            sim::setSerialEcho(true);
+        } else {
+            fprintf(stderr, "usage: %s [--seed N] [--serial]\n", argv[0]);
+            return 2;
+        }
+    }
+    Soak soak(seed);
+    return soak.run();
+}
@@ -0,0 +1,53 @@
+#include "ChunkedResponse.h"
+
+ChunkedResponse::ChunkedResponse(WebServer& server)
+    : _server(server), _len(0) {
+}
+
+void ChunkedResponse::begin(int code, const char* contentType) {
+    _server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+    _server.send(code, contentType, "");
+}
+
+void ChunkedResponse::end() {
+    flush();
+    // Zero-length chunk terminates the chunked response
+    _server.sendContent("");
+}
+
+void ChunkedResponse::print(const char* str) {
+    print(str, strlen(str));
+}
+
+void ChunkedResponse::print(const char* str, size_t len) {
+    while (len > 0) {
+        if (_len == BUFFER_SIZE) flush();
+        size_t n = BUFFER_SIZE - _len;
+        if (n > len) n = len;
+        memcpy(_buf + _len, str, n);
+        _len += n;
+        str += n;
+        len -= n;
+    }
+}
+
+void ChunkedResponse::print(const String& str) {
+    print(str.c_str(), str.length());
+}
+
+void ChunkedResponse::print(const __FlashStringHelper* str) {
+    flush();
+    _server.sendContent_P(reinterpret_cast<PGM_P>(str));
+}
+
+void ChunkedResponse::print(int n) {
+    char num[12];
+    int len = snprintf(num, sizeof(num), "%d", n);
+    print(num, len);
+}
+
+void ChunkedResponse::flush() {
+    if (_len == 0) return;
+    _server.sendContent(_buf, _len);
+    _len = 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <Arduino.h>
+#include <WebServer.h>
+
+// Streams a response body as HTTP chunks through a small fixed buffer,
+// so pages can be emitted piece by piece without building them in a String.
+class ChunkedResponse {
+public:
+    ChunkedResponse(WebServer& server);
+    
+    // Sends the status line and headers; call once before writing any content
+    void begin(int code, const char* contentType);
+    // Flushes the remaining buffer and terminates the chunked response
+    void end();
+    
+    void print(const char* str);
+    void print(const char* str, size_t len);
+    void print(const String& str);
+    // Large PROGMEM blocks bypass the buffer and are sent as a chunk of their own
+    void print(const __FlashStringHelper* str);
+    void print(int n);
+
+private:
+    static const size_t BUFFER_SIZE = 256;
+    
+    WebServer& _server;
+    char _buf[BUFFER_SIZE];
+    size_t _len;
+    
+    void flush();
+};
@@ -44,19 +44,20 @@ SystemConfig ConfigManager::load() {
 }
 
 void ConfigManager::save(const SystemConfig& cfg) {
-    _prefs.putString("dev_name", cfg.device_name);
-    _prefs.putString("wifi_ssid", cfg.wifi_ssid);
-    _prefs.putString("wifi_pass", cfg.wifi_pass);
+    // Pass c_str(): the String overload of putString() takes its argument by value
+    _prefs.putString("dev_name", cfg.device_name.c_str());
+    _prefs.putString("wifi_ssid", cfg.wifi_ssid.c_str());
+    _prefs.putString("wifi_pass", cfg.wifi_pass.c_str());
     _prefs.putBool("wifi_dhcp", cfg.wifi_dhcp);
-    _prefs.putString("wifi_ip", cfg.wifi_ip);
-    _prefs.putString("wifi_gateway", cfg.wifi_gateway);
-    _prefs.putString("wifi_subnet", cfg.wifi_subnet);
-    _prefs.putString("wifi_dns", cfg.wifi_dns);
-    _prefs.putString("ap_ssid", cfg.ap_ssid);
-    _prefs.putString("ap_pass", cfg.ap_pass);
+    _prefs.putString("wifi_ip", cfg.wifi_ip.c_str());
+    _prefs.putString("wifi_gateway", cfg.wifi_gateway.c_str());
+    _prefs.putString("wifi_subnet", cfg.wifi_subnet.c_str());
+    _prefs.putString("wifi_dns", cfg.wifi_dns.c_str());
+    _prefs.putString("ap_ssid", cfg.ap_ssid.c_str());
+    _prefs.putString("ap_pass", cfg.ap_pass.c_str());
     _prefs.putUShort("ap_to", cfg.ap_timeout);
     _prefs.putBool("ota_en", cfg.ota_enabled);
-    _prefs.putString("ota_url", cfg.ota_url);
+    _prefs.putString("ota_url", cfg.ota_url.c_str());
     _prefs.putUInt("ota_int", cfg.ota_check_interval);
 }
 
@@ -0,0 +1,230 @@
+#include "JsonReader.h"
+
+JsonReader::JsonReader(const char* json, size_t len)
+    : _p(json), _end(json + len), _error(nullptr) {
+    if (len > MAX_INPUT) fail("Body too large");
+}
+
+bool JsonReader::parseObject(JsonField* fields, size_t count) {
+    if (_error) return false;
+    for (size_t i = 0; i < count; i++) fields[i].present = false;
+    
+    skipWhitespace();
+    if (!consume('{')) return fail("Expected object");
+    skipWhitespace();
+    
+    if (!consume('}')) {
+        while (true) {
+            char key[MAX_KEY];
+            skipWhitespace();
+            // No accepted key is longer than MAX_KEY - 1, so one that overflows is unknown
+            if (!parseString(key, sizeof(key), "Unknown key")) return false;
+            
+            JsonField* field = findField(fields, count, key);
+            if (!field) return fail("Unknown key");
+            if (field->present) return fail("Duplicate key");
+            
+            skipWhitespace();
+            if (!consume(':')) return fail("Expected ':'");
+            skipWhitespace();
+            
+            bool ok;
+            switch (field->type) {
+                case JSON_STRING: ok = parseString(field->str, field->capacity); break;
+                case JSON_BOOL:   ok = parseBool(field->boolean); break;
+                default:          ok = skipScalar(); break;
+            }
+            if (!ok) return false;
+            field->present = true;
+            
+            skipWhitespace();
+            if (consume('}')) break;
+            if (!consume(',')) return fail("Expected ',' or '}'");
+        }
+    }
+    
+    skipWhitespace();
+    if (_p != _end) return fail("Trailing data");
+    return true;
+}
+
+const char* JsonReader::error() const {
+    return _error;
+}
+
+JsonField* JsonReader::findField(JsonField* fields, size_t count, const char* key) {
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(fields[i].key, key) == 0) return &fields[i];
+    }
+    return nullptr;
+}
+
+bool JsonReader::fail(const char* msg) {
+    // Keep the innermost (first) error
+    if (!_error) _error = msg;
+    return false;
+}
+
+void JsonReader::skipWhitespace() {
+    while (_p < _end && (*_p == ' ' || *_p == '\t' || *_p == '\n' || *_p == '\r')) _p++;
+}
+
+bool JsonReader::consume(char c) {
+    if (_p < _end && *_p == c) {
+        _p++;
+        return true;
+    }
+    return false;
+}
+
+bool JsonReader::parseString(char* out, size_t capacity, const char* tooLong) {
+    if (!consume('"')) return fail("Expected string");
+    
+    size_t len = 0;
+    while (true) {
+        if (_p >= _end) return fail("Unterminated string");
+        char c = *_p++;
+        if (c == '"') break;
+        if ((uint8_t)c < 0x20) return fail("Control character in string");
+        
+        // Decoded bytes of this character: 1, or up to 4 for a \u escape encoded as UTF-8
+        char bytes[4] = {c};
+        size_t n = 1;
+        
+        if (c == '\\') {
+            if (_p >= _end) return fail("Unterminated string");
+            char e = *_p++;
+            switch (e) {
+                case '"':  bytes[0] = '"'; break;
+                case '\\': bytes[0] = '\\'; break;
+                case '/':  bytes[0] = '/'; break;
+                case 'b':  bytes[0] = '\b'; break;
+                case 'f':  bytes[0] = '\f'; break;
+                case 'n':  bytes[0] = '\n'; break;
+                case 'r':  bytes[0] = '\r'; break;
+                case 't':  bytes[0] = '\t'; break;
+                case 'u': {
+                    uint16_t unit;
+                    if (!parseHex4(&unit)) return false;
+                    uint32_t code = unit;
+                    if (unit >= 0xDC00 && unit <= 0xDFFF) return fail("Invalid surrogate");
+                    if (unit >= 0xD800 && unit <= 0xDBFF) {
+                        // High surrogate: only valid as the first half of a \uXXXX\uXXXX pair
+                        uint16_t low;
+                        if (_end - _p < 2 || _p[0] != '\\' || _p[1] != 'u') return fail("Invalid surrogate");
+                        _p += 2;
+                        if (!parseHex4(&low)) return false;
+                        if (low < 0xDC00 || low > 0xDFFF) return fail("Invalid surrogate");
+                        code = 0x10000 + (((uint32_t)(unit - 0xD800) << 10) | (low - 0xDC00));
+                    }
+                    // NUL would silently truncate the C string
+                    if (code == 0) return fail("Unsupported escape");
+                    n = encodeUtf8(code, bytes);
+                    break;
+                }
+                default:
+                    return fail("Invalid escape");
+            }
+        }
+        
+        if (!out) continue;
+        // Every encoded byte counts against capacity, so a \u escape costs 1-4 bytes
+        if (len + n >= capacity) return fail(tooLong);
+        memcpy(out + len, bytes, n);
+        len += n;
+    }
+    
+    if (out) out[len] = '\0';
+    return true;
+}
+
+bool JsonReader::parseHex4(uint16_t* out) {
+    if (_end - _p < 4) return fail("Invalid escape");
+    uint16_t code = 0;
+    for (int i = 0; i < 4; i++) {
+        char h = *_p++;
+        code <<= 4;
+        if (h >= '0' && h <= '9') code |= h - '0';
+        else if (h >= 'a' && h <= 'f') code |= h - 'a' + 10;
+        else if (h >= 'A' && h <= 'F') code |= h - 'A' + 10;
+        else return fail("Invalid escape");
+    }
+    *out = code;
+    return true;
+}
+
+size_t JsonReader::encodeUtf8(uint32_t code, char* out) {
+    if (code < 0x80) {
+        out[0] = (char)code;
+        return 1;
+    }
+    if (code < 0x800) {
+        out[0] = (char)(0xC0 | (code >> 6));
+        out[1] = (char)(0x80 | (code & 0x3F));
+        return 2;
+    }
+    if (code < 0x10000) {
+        out[0] = (char)(0xE0 | (code >> 12));
+        out[1] = (char)(0x80 | ((code >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (code & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (code >> 18));
+    out[1] = (char)(0x80 | ((code >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((code >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (code & 0x3F));
+    return 4;
+}
+
+bool JsonReader::parseBool(bool* out) {
+    if (_end - _p >= 4 && memcmp(_p, "true", 4) == 0) {
+        _p += 4;
+        *out = true;
+        return true;
+    }
+    if (_end - _p >= 5 && memcmp(_p, "false", 5) == 0) {
+        _p += 5;
+        *out = false;
+        return true;
+    }
+    return fail("Expected boolean");
+}
+
+bool JsonReader::skipNumber() {
+    // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+    consume('-');
+    if (_p >= _end || *_p < '0' || *_p > '9') return fail("Invalid number");
+    if (*_p++ != '0') {
+        while (_p < _end && *_p >= '0' && *_p <= '9') _p++;
+    }
+    if (consume('.')) {
+        if (_p >= _end || *_p < '0' || *_p > '9') return fail("Invalid number");
+        while (_p < _end && *_p >= '0' && *_p <= '9') _p++;
+    }
+    if (consume('e') || consume('E')) {
+        if (!consume('+')) consume('-');
+        if (_p >= _end || *_p < '0' || *_p > '9') return fail("Invalid number");
+        while (_p < _end && *_p >= '0' && *_p <= '9') _p++;
+    }
+    return true;
+}
+
+bool JsonReader::skipScalar() {
+    if (_p >= _end) return fail("Expected value");
+    char c = *_p;
+    if (c == '"') return parseString(nullptr, 0);
+    if (c == 't' || c == 'f') {
+        bool ignored;
+        return parseBool(&ignored);
+    }
+    if (c == 'n') {
+        if (_end - _p >= 4 && memcmp(_p, "null", 4) == 0) {
+            _p += 4;
+            return true;
+        }
+        return fail("Expected value");
+    }
+    if (c == '-' || (c >= '0' && c <= '9')) return skipNumber();
+    // Objects and arrays
+    return fail("Nested values not supported");
+}
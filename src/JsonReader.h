@@ -0,0 +1,52 @@
+#pragma once
+#include <Arduino.h>
+
+enum JsonFieldType {
+    JSON_STRING,
+    JSON_BOOL,
+    JSON_IGNORE         // Any scalar (string, number, bool, null); validated and discarded
+};
+
+// Accepted member of a flat JSON object and where its value is decoded to
+struct JsonField {
+    const char* key;
+    JsonFieldType type;
+    char* str;          // JSON_STRING: NUL-terminated destination
+    size_t capacity;    // JSON_STRING: size of str including the NUL
+    bool* boolean;      // JSON_BOOL: destination
+    bool present;       // Set by the parser when the key was seen
+};
+
+// Strict, bounded parser for a single flat JSON object of scalar members.
+// Decodes straight into caller-owned fixed buffers; unknown or duplicate keys,
+// nesting, oversized values and trailing data are rejected.
+class JsonReader {
+public:
+    static const size_t MAX_INPUT = 1024;
+    static const size_t MAX_KEY = 24;
+    
+    JsonReader(const char* json, size_t len);
+    bool parseObject(JsonField* fields, size_t count);
+    const char* error() const;
+    
+    // Field with the given key, or nullptr if it is not in the list
+    static JsonField* findField(JsonField* fields, size_t count, const char* key);
+
+private:
+    const char* _p;
+    const char* _end;
+    const char* _error;
+    
+    bool fail(const char* msg);
+    void skipWhitespace();
+    bool consume(char c);
+    // tooLong: error reported when the decoded string does not fit in capacity.
+    // A null out validates the string without storing it.
+    bool parseString(char* out, size_t capacity, const char* tooLong = "Value too long");
+    bool parseHex4(uint16_t* out);
+    // Writes code point as 1-4 UTF-8 bytes to out; returns the byte count
+    static size_t encodeUtf8(uint32_t code, char* out);
+    bool parseBool(bool* out);
+    bool skipNumber();
+    bool skipScalar();
+};
@@ -0,0 +1,113 @@
+#include "JsonWriter.h"
+
+JsonWriter::JsonWriter(WebServer& server)
+    : _server(server), _out(server), _depth(0), _afterKey(false) {
+}
+
+void JsonWriter::begin(int code) {
+    _server.sendHeader("Cache-Control", "no-store");
+    _out.begin(code, "application/json");
+}
+
+void JsonWriter::end() {
+    _out.end();
+}
+
+void JsonWriter::beginObject() {
+    separator();
+    put('{');
+    if (_depth < MAX_DEPTH) _hasMember[_depth] = false;
+    _depth++;
+}
+
+void JsonWriter::endObject() {
+    if (_depth > 0) _depth--;
+    put('}');
+}
+
+void JsonWriter::key(const char* name) {
+    separator();
+    putString(name, strlen(name));
+    put(':');
+    _afterKey = true;
+}
+
+void JsonWriter::value(const char* str) {
+    separator();
+    putString(str, strlen(str));
+}
+
+void JsonWriter::value(const String& str) {
+    separator();
+    putString(str.c_str(), str.length());
+}
+
+void JsonWriter::value(bool b) {
+    separator();
+    if (b) put("true", 4);
+    else put("false", 5);
+}
+
+void JsonWriter::value(int32_t n) {
+    separator();
+    char num[12];
+    int len = snprintf(num, sizeof(num), "%ld", (long)n);
+    put(num, len);
+}
+
+void JsonWriter::value(uint32_t n) {
+    separator();
+    char num[12];
+    int len = snprintf(num, sizeof(num), "%lu", (unsigned long)n);
+    put(num, len);
+}
+
+void JsonWriter::nullValue() {
+    separator();
+    put("null", 4);
+}
+
+void JsonWriter::separator() {
+    // Values following a key, and the first member of an object, need no comma
+    if (_afterKey) {
+        _afterKey = false;
+        return;
+    }
+    if (_depth == 0 || _depth > MAX_DEPTH) return;
+    if (_hasMember[_depth - 1]) put(',');
+    _hasMember[_depth - 1] = true;
+}
+
+void JsonWriter::put(char c) {
+    _out.print(&c, 1);
+}
+
+void JsonWriter::put(const char* str, size_t len) {
+    _out.print(str, len);
+}
+
+void JsonWriter::putString(const char* str, size_t len) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    put('"');
+    for (size_t i = 0; i < len; i++) {
+        char c = str[i];
+        switch (c) {
+            case '"':  put("\\\"", 2); break;
+            case '\\': put("\\\\", 2); break;
+            case '\b': put("\\b", 2); break;
+            case '\f': put("\\f", 2); break;
+            case '\n': put("\\n", 2); break;
+            case '\r': put("\\r", 2); break;
+            case '\t': put("\\t", 2); break;
+            default:
+                if ((uint8_t)c < 0x20) {
+                    char esc[6] = {'\\', 'u', '0', '0', HEX_DIGITS[(c >> 4) & 0xF], HEX_DIGITS[c & 0xF]};
+                    put(esc, sizeof(esc));
+                } else {
+                    put(c);
+                }
+                break;
+        }
+    }
+    put('"');
+}
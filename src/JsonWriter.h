@@ -0,0 +1,41 @@
+#pragma once
+#include <Arduino.h>
+#include <WebServer.h>
+#include "ChunkedResponse.h"
+
+// Streaming JSON writer that emits directly into a chunked WebServer response.
+// Output is staged in ChunkedResponse's fixed buffer, so no String or DOM is built on the heap.
+class JsonWriter {
+public:
+    JsonWriter(WebServer& server);
+    
+    // Starts the chunked response; call once before writing any value
+    void begin(int code);
+    // Flushes the remaining buffer and terminates the chunked response
+    void end();
+    
+    void beginObject();
+    void endObject();
+    void key(const char* name);
+    
+    void value(const char* str);
+    void value(const String& str);
+    void value(bool b);
+    void value(int32_t n);
+    void value(uint32_t n);
+    void nullValue();
+
+private:
+    static const uint8_t MAX_DEPTH = 8;
+    
+    WebServer& _server;
+    ChunkedResponse _out;
+    uint8_t _depth;
+    bool _hasMember[MAX_DEPTH];
+    bool _afterKey;
+    
+    void separator();
+    void put(char c);
+    void put(const char* str, size_t len);
+    void putString(const char* str, size_t len);
+};
@@ -1,10 +1,14 @@
 #include "NetworkManager.h"
 #include "html_pages.h"
 #include "definitions.h"
+#include "ChunkedResponse.h"
+#include "JsonWriter.h"
+#include "JsonReader.h"
 #include <Update.h>
 
-NetworkManager::NetworkManager(ConfigManager& configMgr) 
-    : _configMgr(configMgr), _server(80), _apMode(false), _lastWifiCheck(0), _lastNetworkStatus(WL_IDLE_STATUS) {
+NetworkManager::NetworkManager(ConfigManager& configMgr, SOSBlinker& blinker) 
+    : _configMgr(configMgr), _blinker(blinker), _server(80), _apMode(false), _lastWifiCheck(0), _lastStatusBlink(0), _lastNetworkStatus(WL_IDLE_STATUS),
+      _btnPressed(false), _btnPressStart(0) {
 }
 
 void NetworkManager::begin() {
@@ -30,8 +34,11 @@ void NetworkManager::update() {
     if (_apMode) {
         _dnsServer.processNextRequest();
         // AP Blink: 2s period (1s on, 1s off)
-        if ((millis() % 2000) < 1000) digitalWrite(PIN_LED_STATUS, HIGH);
-        else digitalWrite(PIN_LED_STATUS, LOW);
+        // Elapsed-time toggle; millis() % 2000 jumps phase at the 49.7-day rollover
+        if (millis() - _lastStatusBlink >= 1000) {
+            _lastStatusBlink = millis();
+            digitalWrite(PIN_LED_STATUS, !digitalRead(PIN_LED_STATUS));
+        }
     } else {
         // STA Mode: OFF (Status LED)
         digitalWrite(PIN_LED_STATUS, LOW);
@@ -63,17 +70,18 @@ void NetworkManager::update() {
     }
     
     // Button Logic (Hold 5s to force AP)
-    static unsigned long btnPressStart = 0;
     if (digitalRead(PIN_BTN_CONFIG) == LOW) {
-        if (btnPressStart == 0) btnPressStart = millis();
-        else if (millis() - btnPressStart > 5000) {
+        if (!_btnPressed) {
+            _btnPressed = true;
+            _btnPressStart = millis();
+        } else if (millis() - _btnPressStart > 5000) {
             startAP();
-            btnPressStart = 0;
+            _btnPressed = false;
             // Wait for release
             while(digitalRead(PIN_BTN_CONFIG) == LOW) delay(10);
         }
     } else {
-        btnPressStart = 0;
+        _btnPressed = false;
     }
 }
 
@@ -115,6 +123,9 @@ void NetworkManager::startAP() {
 void NetworkManager::setupWebServer() {
     _server.on("/", HTTP_GET, std::bind(&NetworkManager::handleRoot, this));
     _server.on("/save", HTTP_POST, std::bind(&NetworkManager::handleSave, this));
+    _server.on("/api/status", HTTP_GET, std::bind(&NetworkManager::handleApiStatus, this));
+    _server.on("/api/config", HTTP_GET, std::bind(&NetworkManager::handleApiConfig, this));
+    _server.on("/api/config", HTTP_POST, std::bind(&NetworkManager::handleApiConfigSave, this));
     _server.on("/generate_204", std::bind(&NetworkManager::handleNotFound, this));
     _server.on("/hotspot-detect.html", std::bind(&NetworkManager::handleNotFound, this));
     _server.onNotFound(std::bind(&NetworkManager::handleNotFound, this));
@@ -164,7 +175,7 @@ void NetworkManager::setupWebServer() {
                 }
 
                 // OTA Update Blink: Every 250ms (FSD)
-                static unsigned long lastBlink = 0;
+                static uint32_t lastBlink = 0;
                 if (millis() - lastBlink > 125) { // 125ms on, 125ms off -> 250ms period (4Hz)
                     lastBlink = millis();
                     digitalWrite(PIN_LED_STATUS, !digitalRead(PIN_LED_STATUS));
@@ -181,71 +192,100 @@ void NetworkManager::setupWebServer() {
 }
 
 void NetworkManager::handleRoot() {
-    String html = FPSTR(PAGE_HEADER);
+    // Stream the page in small chunks: a page-sized String would need one multi-KB
+    // contiguous block per load and fragment the heap over months of uptime
+    int n = _apMode ? WiFi.scanNetworks() : 0;
+    
+    ChunkedResponse page(_server);
+    page.begin(200, "text/html");
+    page.print(FPSTR(PAGE_HEADER));
     
     // WiFi Scan
-    html += "<div class='card'><h2>WiFi Configuration</h2><div class='scan-results'>";
+    page.print("<div class='card'><h2>WiFi Configuration</h2><div class='scan-results'>");
     if (_apMode) {
-        int n = WiFi.scanNetworks();
         if (n == 0) {
-            html += "<div class='scan-item'>No networks found</div>";
+            page.print("<div class='scan-item'>No networks found</div>");
         } else if (n < 0) {
-            html += "<div class='scan-item'>Scan failed</div>";
+            page.print("<div class='scan-item'>Scan failed</div>");
         } else {
             for (int i = 0; i < n; ++i) {
-                String rssi = String(WiFi.RSSI(i));
+                // Read the scan record in place instead of copying each SSID into a String
+                const wifi_ap_record_t* ap = static_cast<const wifi_ap_record_t*>(WiFi.getScanInfoByIndex(i));
+                if (!ap) continue;
+                const char* ssid = reinterpret_cast<const char*>(ap->ssid);
                 // Simple visual indicator for signal strength could be added here
-                html += "<div class='scan-item' onclick=\"selectNetwork('" + WiFi.SSID(i) + "')\">";
-                html += "<strong>" + WiFi.SSID(i) + "</strong> (" + rssi + " dBm)</div>";
+                page.print("<div class='scan-item' onclick=\"selectNetwork('");
+                page.print(ssid);
+                page.print("')\"><strong>");
+                page.print(ssid);
+                page.print("</strong> (");
+                page.print(ap->rssi);
+                page.print(" dBm)</div>");
             }
         }
+        // Release the scan result list now instead of holding it until the next scan
+        WiFi.scanDelete();
     } else {
-        html += "<div class='scan-item'>Scanning disabled in Station Mode.<br>Switch to AP mode to scan.</div>";
+        page.print("<div class='scan-item'>Scanning disabled in Station Mode.<br>Switch to AP mode to scan.</div>");
         if (WiFi.status() == WL_CONNECTED) {
-             html += "<div class='scan-item'><strong>Current: " + _config.wifi_ssid + "</strong> (" + String(WiFi.RSSI()) + " dBm)</div>";
+            page.print("<div class='scan-item'><strong>Current: ");
+            page.print(_config.wifi_ssid);
+            page.print("</strong> (");
+            page.print(WiFi.RSSI());
+            page.print(" dBm)</div>");
         }
     }
-    html += "</div></div>";
+    page.print("</div></div>");
     
     // WiFi Config Form
-    html += "<div class='card'><form action='/save' method='POST'>";
-    html += "<label>SSID:</label><input type='text' id='ssid' name='ssid' value='" + _config.wifi_ssid + "'>";
-    html += "<label>Password:</label><input type='password' id='pass' name='pass' value='" + _config.wifi_pass + "'>";
+    page.print("<div class='card'><form action='/save' method='POST'>");
+    page.print("<label>SSID:</label><input type='text' id='ssid' name='ssid' value='");
+    page.print(_config.wifi_ssid);
+    page.print("'><label>Password:</label><input type='password' id='pass' name='pass' value='");
+    page.print(_config.wifi_pass);
+    page.print("'>");
     
     // DHCP Toggle
-    String checked = _config.wifi_dhcp ? "checked" : "";
-    String manualStyle = _config.wifi_dhcp ? "display:none" : "display:block";
-    
-    html += "<label><input type='checkbox' name='dhcp' " + checked + " onchange='toggleIP(this.checked)'> Use DHCP</label>";
+    page.print("<label><input type='checkbox' name='dhcp' ");
+    page.print(_config.wifi_dhcp ? "checked" : "");
+    page.print(" onchange='toggleIP(this.checked)'> Use DHCP</label>");
     
     // Manual IP Fields
-    html += "<div id='manual_ip' style='" + manualStyle + "'>";
-    html += "<label>IP Address:</label><input type='text' name='ip' value='" + _config.wifi_ip + "'>";
-    html += "<label>Gateway:</label><input type='text' name='gateway' value='" + _config.wifi_gateway + "'>";
-    html += "<label>Subnet Mask:</label><input type='text' name='subnet' value='" + _config.wifi_subnet + "'>";
-    html += "<label>DNS Server:</label><input type='text' name='dns' value='" + _config.wifi_dns + "'>";
-    html += "</div>";
+    page.print("<div id='manual_ip' style='");
+    page.print(_config.wifi_dhcp ? "display:none" : "display:block");
+    page.print("'><label>IP Address:</label><input type='text' name='ip' value='");
+    page.print(_config.wifi_ip);
+    page.print("'><label>Gateway:</label><input type='text' name='gateway' value='");
+    page.print(_config.wifi_gateway);
+    page.print("'><label>Subnet Mask:</label><input type='text' name='subnet' value='");
+    page.print(_config.wifi_subnet);
+    page.print("'><label>DNS Server:</label><input type='text' name='dns' value='");
+    page.print(_config.wifi_dns);
+    page.print("'></div>");
     
-    html += "<button type='submit'>Save & Connect</button></form></div>";
+    page.print("<button type='submit'>Save & Connect</button></form></div>");
     
     // Firmware Update
     uint32_t freeSpace = ESP.getFreeSketchSpace();
-    String freeSpaceStr = String(freeSpace / 1024.0 / 1024.0, 2) + " MB";
+    char freeSpaceMb[16];
+    snprintf(freeSpaceMb, sizeof(freeSpaceMb), "%.2f", freeSpace / 1024.0 / 1024.0);
     
-    html += "<div class='card'><h2>Firmware Update</h2>";
-    html += "<p><strong>Current Version:</strong> 1.0.0</p>"; // Hardcoded per FSD
-    html += "<p><strong>Build Date:</strong> " + String(__DATE__) + " " + String(__TIME__) + "</p>";
-    html += "<p><strong>Free Space:</strong> " + freeSpaceStr + "</p>";
+    page.print("<div class='card'><h2>Firmware Update</h2>");
+    page.print("<p><strong>Current Version:</strong> 1.0.0</p>"); // Hardcoded per FSD
+    page.print("<p><strong>Build Date:</strong> " __DATE__ " " __TIME__ "</p>");
+    page.print("<p><strong>Free Space:</strong> ");
+    page.print(freeSpaceMb);
+    page.print(" MB</p>");
     
-    html += "<input type='file' id='update_file' name='update'>";
-    html += "<button onclick='uploadFile()'>Upload Firmware</button>";
+    page.print("<input type='file' id='update_file' name='update'>");
+    page.print("<button onclick='uploadFile()'>Upload Firmware</button>");
     
-    html += "<div id='progress-container'><div id='progress-bar'><div id='progress-fill'>0%</div></div></div>";
-    html += "<p style='font-size:0.8em; color:#999;'>⚠ Do not power off during update</p>";
-    html += "</div>";
+    page.print("<div id='progress-container'><div id='progress-bar'><div id='progress-fill'>0%</div></div></div>");
+    page.print("<p style='font-size:0.8em; color:#999;'>⚠ Do not power off during update</p>");
+    page.print("</div>");
     
-    html += FPSTR(PAGE_FOOTER);
-    _server.send(200, "text/html", html);
+    page.print(FPSTR(PAGE_FOOTER));
+    page.end();
 }
 
 void NetworkManager::handleSave() {
@@ -274,6 +314,173 @@ void NetworkManager::handleNotFound() {
     }
 }
 
+void NetworkManager::handleApiStatus() {
+    bool connected = isConnected();
+    
+    JsonWriter json(_server);
+    json.begin(200);
+    json.beginObject();
+    json.key("version"); json.value("1.0.0"); // Hardcoded per FSD
+    json.key("device_name"); json.value(_config.device_name);
+    json.key("mode"); json.value(_apMode ? "ap" : "sta");
+    json.key("ap_mode"); json.value(isAPMode());
+    json.key("connected"); json.value(connected);
+    json.key("ssid"); json.value(_apMode ? _config.ap_ssid : _config.wifi_ssid);
+    
+    // IPAddress::toString() allocates, so format into a stack buffer instead
+    char ipBuf[16];
+    IPAddress ip = _apMode ? WiFi.softAPIP() : WiFi.localIP();
+    snprintf(ipBuf, sizeof(ipBuf), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+    json.key("ip"); json.value(ipBuf);
+    
+    json.key("rssi");
+    if (connected) json.value((int32_t)WiFi.RSSI());
+    else json.nullValue();
+    
+    json.key("blinker_running"); json.value(_blinker.isRunning());
+    json.key("free_sketch_space"); json.value((uint32_t)ESP.getFreeSketchSpace());
+    json.key("free_heap"); json.value((uint32_t)ESP.getFreeHeap());
+    json.key("max_alloc_heap"); json.value((uint32_t)ESP.getMaxAllocHeap());
+    json.key("uptime_ms"); json.value((uint32_t)millis());
+    json.endObject();
+    json.end();
+}
+
+void NetworkManager::handleApiConfig() {
+    JsonWriter json(_server);
+    json.begin(200);
+    json.beginObject();
+    json.key("device_name"); json.value(_config.device_name);
+    json.key("ssid"); json.value(_config.wifi_ssid);
+    // Never echo secrets back over the API, only whether one is set
+    json.key("pass_set"); json.value(_config.wifi_pass.length() > 0);
+    json.key("dhcp"); json.value(_config.wifi_dhcp);
+    json.key("ip"); json.value(_config.wifi_ip);
+    json.key("gateway"); json.value(_config.wifi_gateway);
+    json.key("subnet"); json.value(_config.wifi_subnet);
+    json.key("dns"); json.value(_config.wifi_dns);
+    json.key("ap_ssid"); json.value(_config.ap_ssid);
+    json.key("ap_timeout"); json.value((uint32_t)_config.ap_timeout);
+    json.key("ota_enabled"); json.value(_config.ota_enabled);
+    json.key("ota_url"); json.value(_config.ota_url);
+    json.key("ota_check_interval"); json.value(_config.ota_check_interval);
+    json.endObject();
+    json.end();
+}
+
+void NetworkManager::handleApiConfigSave() {
+    // WebServer only exposes the raw body as "plain" when it is not form-encoded,
+    // so a body sent as application/x-www-form-urlencoded (curl -d) ends up here too
+    if (!_server.hasArg("plain")) {
+        sendApiError(400, "Missing JSON body");
+        return;
+    }
+    
+    // Same fields as the /save form; sizes follow 802.11 (SSID 32, passphrase 64) and dotted IPv4
+    char ssid[33], pass[65], ip[16], gateway[16], subnet[16], dns[16];
+    bool dhcp = _config.wifi_dhcp;
+    JsonField fields[] = {
+        {"ssid",    JSON_STRING, ssid,    sizeof(ssid),    nullptr, false},
+        {"pass",    JSON_STRING, pass,    sizeof(pass),    nullptr, false},
+        {"dhcp",    JSON_BOOL,   nullptr, 0,               &dhcp,   false},
+        {"ip",      JSON_STRING, ip,      sizeof(ip),      nullptr, false},
+        {"gateway", JSON_STRING, gateway, sizeof(gateway), nullptr, false},
+        {"subnet",  JSON_STRING, subnet,  sizeof(subnet),  nullptr, false},
+        {"dns",     JSON_STRING, dns,     sizeof(dns),     nullptr, false},
+        // Read-only keys from GET /api/config, so a fetched document can be edited and posted back
+        {"device_name",        JSON_IGNORE, nullptr, 0, nullptr, false},
+        {"pass_set",           JSON_IGNORE, nullptr, 0, nullptr, false},
+        {"ap_ssid",            JSON_IGNORE, nullptr, 0, nullptr, false},
+        {"ap_timeout",         JSON_IGNORE, nullptr, 0, nullptr, false},
+        {"ota_enabled",        JSON_IGNORE, nullptr, 0, nullptr, false},
+        {"ota_url",            JSON_IGNORE, nullptr, 0, nullptr, false},
+        {"ota_check_interval", JSON_IGNORE, nullptr, 0, nullptr, false},
+    };
+    const size_t fieldCount = sizeof(fields) / sizeof(fields[0]);
+    
+    const String& body = _server.arg("plain");
+    // WebServer has already buffered the whole body by now, so this only bounds the parse
+    if (body.length() > JsonReader::MAX_INPUT) {
+        sendApiError(413, "Body too large");
+        return;
+    }
+    JsonReader reader(body.c_str(), body.length());
+    if (!reader.parseObject(fields, fieldCount)) {
+        sendApiError(400, reader.error());
+        return;
+    }
+    
+    // Address fields must be empty or valid IPv4
+    static const char* const ADDRESS_KEYS[] = {"ip", "gateway", "subnet", "dns"};
+    for (const char* key : ADDRESS_KEYS) {
+        const JsonField* field = JsonReader::findField(fields, fieldCount, key);
+        IPAddress addr;
+        if (field->present && field->str[0] != '\0' && !addr.fromString(field->str)) {
+            sendApiError(400, "Invalid IP address");
+            return;
+        }
+    }
+    
+    // Apply only after the whole body validated, so a bad request changes nothing
+    bool changed = false;
+    const struct {
+        const char* key;
+        String& target;
+    } stringTargets[] = {
+        {"ssid",    _config.wifi_ssid},
+        {"pass",    _config.wifi_pass},
+        {"ip",      _config.wifi_ip},
+        {"gateway", _config.wifi_gateway},
+        {"subnet",  _config.wifi_subnet},
+        {"dns",     _config.wifi_dns},
+    };
+    for (const auto& t : stringTargets) {
+        const JsonField* field = JsonReader::findField(fields, fieldCount, t.key);
+        if (field->present && t.target != field->str) {
+            t.target = field->str;
+            changed = true;
+        }
+    }
+    if (JsonReader::findField(fields, fieldCount, "dhcp")->present && dhcp != _config.wifi_dhcp) {
+        _config.wifi_dhcp = dhcp;
+        changed = true;
+    }
+    
+    // Nothing to save: skip the NVS write and keep the device up
+    if (!changed) {
+        JsonWriter json(_server);
+        json.begin(200);
+        json.beginObject();
+        json.key("status"); json.value("unchanged");
+        json.key("restarting"); json.value(false);
+        json.endObject();
+        json.end();
+        return;
+    }
+    
+    _configMgr.save(_config);
+    
+    JsonWriter json(_server);
+    json.begin(200);
+    json.beginObject();
+    json.key("status"); json.value("saved");
+    json.key("restarting"); json.value(true);
+    json.endObject();
+    json.end();
+    
+    delay(500);
+    ESP.restart();
+}
+
+void NetworkManager::sendApiError(int code, const char* message) {
+    JsonWriter json(_server);
+    json.begin(code);
+    json.beginObject();
+    json.key("error"); json.value(message);
+    json.endObject();
+    json.end();
+}
+
 bool NetworkManager::isConnected() {
     return WiFi.status() == WL_CONNECTED;
 }
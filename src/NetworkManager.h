@@ -5,10 +5,11 @@
 #include <DNSServer.h>
 #include "SystemConfig.h"
 #include "ConfigManager.h"
+#include "SOSBlinker.h"
 
 class NetworkManager {
 public:
-    NetworkManager(ConfigManager& configMgr);
+    NetworkManager(ConfigManager& configMgr, SOSBlinker& blinker);
     void begin();
     void update();
     bool isConnected();
@@ -16,15 +17,21 @@ public:
 
 private:
     ConfigManager& _configMgr;
+    SOSBlinker& _blinker;
     SystemConfig _config;
     
     WebServer _server;
     DNSServer _dnsServer;
     
     bool _apMode;
-    unsigned long _lastWifiCheck;
+    uint32_t _lastWifiCheck;
+    uint32_t _lastStatusBlink;
     wl_status_t _lastNetworkStatus;
     
+    // Config button hold tracking (no 0 sentinel, millis() can legitimately be 0 after rollover)
+    bool _btnPressed;
+    uint32_t _btnPressStart;
+    
     void startSTA();
     void startAP();
     void setupWebServer();
@@ -34,6 +41,12 @@ private:
     void handleSave();
     void handleNotFound();
     
+    // JSON API Handlers
+    void handleApiStatus();
+    void handleApiConfig();
+    void handleApiConfigSave();
+    void sendApiError(int code, const char* message);
+    
     // OTA Handlers
     void handleUpdate();
     void handleUpload();
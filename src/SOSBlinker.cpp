@@ -51,10 +51,10 @@ void SOSBlinker::update() {
         return;
     }
 
-    unsigned long currentMillis = millis();
-    unsigned long elapsed = currentMillis - _lastUpdate;
+    uint32_t currentMillis = millis();
+    uint32_t elapsed = currentMillis - _lastUpdate;
     
-    unsigned long duration = SOS_PATTERN[_state].units * MORSE_UNIT;
+    uint32_t duration = SOS_PATTERN[_state].units * MORSE_UNIT;
     
     if (elapsed >= duration) {
         _state++;
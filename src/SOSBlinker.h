@@ -10,7 +10,7 @@ public:
 
 private:
     uint8_t _pin;
-    unsigned long _lastUpdate;
+    uint32_t _lastUpdate;
     int _state; // Current step in the sequence
     int _repetitions; // Number of full patterns completed
 };
@@ -8,7 +8,7 @@
 // Components
 SOSBlinker sosBlinker(PIN_LED_SOS);
 ConfigManager configMgr;
-NetworkManager netMgr(configMgr);
+NetworkManager netMgr(configMgr, sosBlinker);
 
 void setup() {
     Serial.begin(115200);